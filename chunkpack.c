@@ -0,0 +1,215 @@
+#include "chunkpack.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Bits needed to index a palette of the given size
+ */
+static int palette_bits(int palette_count) {
+    int bits = 0;
+    while ((1 << bits) < palette_count) bits++;
+    return bits;
+}
+
+/**
+ * Pack a tile block into a newly allocated buffer
+ * Returns the packed size, or 0 if the block has too many distinct tiles
+ * (or allocation failed) and should be stored raw.
+ */
+size_t pack_tiles(const WorldTile* tiles, int count, unsigned char** out) {
+    uint64_t palette[CHUNK_PACK_MAX_PALETTE];
+    unsigned char* indices = (unsigned char*)malloc(count > 0 ? count : 1);
+    if (!indices) return 0;
+
+    // Build the palette; runs of the same tile hit the last entry
+    int palette_count = 0;
+    int last = -1;
+    uint64_t last_value = 0;
+
+    for (int i = 0; i < count; i++) {
+        uint64_t value;
+        memcpy(&value, &tiles[i], sizeof(value));
+
+        if (last < 0 || value != last_value) {
+            int found = -1;
+            for (int p = 0; p < palette_count; p++) {
+                if (palette[p] == value) {
+                    found = p;
+                    break;
+                }
+            }
+
+            if (found < 0) {
+                if (palette_count == CHUNK_PACK_MAX_PALETTE) {
+                    free(indices);
+                    return 0;
+                }
+                found = palette_count;
+                palette[palette_count++] = value;
+            }
+
+            last = found;
+            last_value = value;
+        }
+
+        indices[i] = (unsigned char)last;
+    }
+
+    int bits = palette_bits(palette_count);
+    size_t index_bytes = ((size_t)count * bits + 7) / 8;
+    size_t size = CHUNK_PACK_HEADER_SIZE + (size_t)palette_count * sizeof(WorldTile) + index_bytes;
+
+    unsigned char* data = (unsigned char*)calloc(1, size);
+    if (!data) {
+        free(indices);
+        return 0;
+    }
+
+    data[0] = (unsigned char)(palette_count & 0xFF);
+    data[1] = (unsigned char)(palette_count >> 8);
+    data[2] = (unsigned char)bits;
+    memcpy(data + CHUNK_PACK_HEADER_SIZE, palette, (size_t)palette_count * sizeof(WorldTile));
+
+    // Bit-pack the indices, LSB first
+    if (bits > 0) {
+        unsigned char* packed = data + CHUNK_PACK_HEADER_SIZE + (size_t)palette_count * sizeof(WorldTile);
+        size_t bit = 0;
+        for (int i = 0; i < count; i++, bit += bits) {
+            unsigned int value = (unsigned int)indices[i] << (bit & 7);
+            packed[bit >> 3] |= (unsigned char)value;
+            if ((bit & 7) + bits > 8) packed[(bit >> 3) + 1] |= (unsigned char)(value >> 8);
+        }
+    }
+
+    free(indices);
+    *out = data;
+    return size;
+}
+
+/**
+ * Size of a packed tile block, checked against the bytes available
+ * Returns 0 if the header is invalid or the block would overrun.
+ */
+size_t packed_tiles_size(const unsigned char* data, size_t available, int count) {
+    if (!data || available < CHUNK_PACK_HEADER_SIZE || count < 0) return 0;
+
+    int palette_count = data[0] | (data[1] << 8);
+    int bits = data[2];
+    if (palette_count < 1 || palette_count > CHUNK_PACK_MAX_PALETTE ||
+        bits != palette_bits(palette_count))
+        return 0;
+
+    size_t size = CHUNK_PACK_HEADER_SIZE + (size_t)palette_count * sizeof(WorldTile) +
+                  ((size_t)count * bits + 7) / 8;
+    return size <= available ? size : 0;
+}
+
+/**
+ * Decode a packed tile block
+ */
+int unpack_tiles(const unsigned char* data, size_t size, WorldTile* tiles, int count) {
+    if (packed_tiles_size(data, size, count) == 0) return 0;
+
+    int palette_count = data[0] | (data[1] << 8);
+    int bits = data[2];
+    WorldTile palette[CHUNK_PACK_MAX_PALETTE];
+    memcpy(palette, data + CHUNK_PACK_HEADER_SIZE, (size_t)palette_count * sizeof(WorldTile));
+
+    if (bits == 0) {
+        for (int i = 0; i < count; i++) {
+            tiles[i] = palette[0];
+        }
+        return 1;
+    }
+
+    const unsigned char* packed = data + CHUNK_PACK_HEADER_SIZE + (size_t)palette_count * sizeof(WorldTile);
+    unsigned int mask = (1u << bits) - 1;
+    size_t bit = 0;
+
+    for (int i = 0; i < count; i++, bit += bits) {
+        unsigned int value = packed[bit >> 3] >> (bit & 7);
+        if ((bit & 7) + bits > 8) value |= (unsigned int)packed[(bit >> 3) + 1] << (8 - (bit & 7));
+
+        // Indices past the palette only appear in corrupt data
+        unsigned int index = value & mask;
+        if (index >= (unsigned int)palette_count) return 0;
+        tiles[i] = palette[index];
+    }
+
+    return 1;
+}
+
+/**
+ * Decode the single tile at an index of a packed block
+ */
+int packed_tile_at(const unsigned char* data, size_t size, int count, int index, WorldTile* tile) {
+    if (index < 0 || index >= count || packed_tiles_size(data, size, count) == 0) return 0;
+
+    int palette_count = data[0] | (data[1] << 8);
+    int bits = data[2];
+    unsigned int value = 0;
+
+    if (bits > 0) {
+        const unsigned char* packed = data + CHUNK_PACK_HEADER_SIZE + (size_t)palette_count * sizeof(WorldTile);
+        size_t bit = (size_t)index * bits;
+        value = packed[bit >> 3] >> (bit & 7);
+        if ((bit & 7) + bits > 8) value |= (unsigned int)packed[(bit >> 3) + 1] << (8 - (bit & 7));
+        value &= (1u << bits) - 1;
+    }
+
+    if (value >= (unsigned int)palette_count) return 0;
+    memcpy(tile, data + CHUNK_PACK_HEADER_SIZE + (size_t)value * sizeof(WorldTile), sizeof(WorldTile));
+    return 1;
+}
+
+/**
+ * Replace a chunk's tiles with their packed form
+ * Leaves the chunk untouched if packing doesn't apply.
+ */
+int pack_chunk(WorldChunk* chunk) {
+    if (!chunk || !chunk->tiles) return 0;
+
+    unsigned char* data = NULL;
+    size_t size = pack_tiles(chunk->tiles, chunk->width * chunk->height, &data);
+    if (size == 0) return 0;
+
+    free_packed_tiles(chunk);
+    free_chunk_tiles(chunk);
+
+    chunk->packed = data;
+    chunk->packed_size = size;
+    chunk->packed_owned = 1;
+    return 1;
+}
+
+/**
+ * Decode a chunk's packed tiles back into a tile block
+ */
+int unpack_chunk(WorldChunk* chunk) {
+    if (!chunk || !chunk->packed) return 0;
+    if (chunk->tiles) return 1;
+
+    if (!alloc_chunk_tiles(chunk)) return 0;
+
+    if (!unpack_tiles(chunk->packed, chunk->packed_size, chunk->tiles, chunk->width * chunk->height)) {
+        free_chunk_tiles(chunk);
+        return 0;
+    }
+
+    // The tile block is authoritative from now on
+    free_packed_tiles(chunk);
+    return 1;
+}
+
+/**
+ * Drop a chunk's packed tiles (only freed if not part of a save mapping)
+ */
+void free_packed_tiles(WorldChunk* chunk) {
+    if (!chunk) return;
+
+    if (chunk->packed_owned) free((void*)chunk->packed);
+    chunk->packed = NULL;
+    chunk->packed_size = 0;
+    chunk->packed_owned = 0;
+}
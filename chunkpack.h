@@ -0,0 +1,31 @@
+#ifndef CHUNKPACK_H
+#define CHUNKPACK_H
+
+#include "gamestate.h"
+
+/*
+ * Packed tile layout (palette + bit-packing):
+ *
+ *   u8 palette_count_lo | u8 palette_count_hi | u8 bits | u8 reserved
+ *   palette_count raw WorldTiles
+ *   one bits-wide palette index per tile, packed LSB first
+ *
+ * Generated chunks hold a handful of distinct tiles, so a 64x64 chunk of
+ * floor and wall packs into about 530 bytes instead of 32 KB.
+ */
+
+#define CHUNK_PACK_HEADER_SIZE  4
+#define CHUNK_PACK_MAX_PALETTE  256
+
+// Tile block codec
+size_t pack_tiles(const WorldTile* tiles, int count, unsigned char** out);
+size_t packed_tiles_size(const unsigned char* data, size_t available, int count);
+int unpack_tiles(const unsigned char* data, size_t size, WorldTile* tiles, int count);
+int packed_tile_at(const unsigned char* data, size_t size, int count, int index, WorldTile* tile);
+
+// Dormant chunk storage
+int pack_chunk(WorldChunk* chunk);
+int unpack_chunk(WorldChunk* chunk);
+void free_packed_tiles(WorldChunk* chunk);
+
+#endif /* CHUNKPACK_H */
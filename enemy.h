@@ -13,6 +13,6 @@ typedef struct enemy {
 } enemy;
 
 // Function declaration only - implementation will be in enemy.c
-int followPlayer(int* collisionMap, int enemyX, int enemyY, int playerPosX, int playerPosY);
+int followPlayer(const unsigned short* distanceMap, int width, int height, int enemyX, int enemyY);
 
 #endif /* ENEMY_H */
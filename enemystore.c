@@ -0,0 +1,247 @@
+#include "enemystore.h"
+#include <string.h>
+
+/**
+ * Resize one field array, leaving it untouched on failure
+ */
+static int resize_array(void** array, int capacity, size_t element_size) {
+    void* resized = realloc(*array, (size_t)capacity * element_size);
+    if (!resized) return 0;
+    *array = resized;
+    return 1;
+}
+
+/**
+ * Make room for at least capacity enemies in every field array
+ */
+static int enemy_store_reserve(EnemyStore* store, int capacity) {
+    if (capacity <= store->capacity) return 1;
+    
+    int new_capacity = store->capacity ? store->capacity : 16;
+    while (new_capacity < capacity) new_capacity *= 2;
+    
+    if (!resize_array((void**)&store->x, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->y, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->ai_state, new_capacity, sizeof(unsigned char)) ||
+        !resize_array((void**)&store->detection_radius, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->id, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->brain, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->health, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->faction_id, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->ai_target_id, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->behavior_flags, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->last_action_time, new_capacity, sizeof(int)) ||
+        !resize_array((void**)&store->icon, new_capacity, sizeof(char)) ||
+        !resize_array((void**)&store->name, new_capacity, sizeof(char*)))
+        return 0;
+    
+    store->capacity = new_capacity;
+    return 1;
+}
+
+/**
+ * Add an enemy; returns its index or -1
+ * An id of 0 gets a fresh handle; a handle from a save is kept
+ */
+int enemy_store_add(EnemyStore* store, const AIEnemy* enemy) {
+    if (!store || !enemy) return -1;
+    if (!enemy_store_reserve(store, store->count + 1)) return -1;
+    
+    int i = store->count;
+    int id = slot_map_claim(&store->handles, enemy->id, i);
+    if (id == 0) return -1;
+    
+    if (!spatial_insert(&store->grid, handle_slot(id), enemy->base.x, enemy->base.y)) {
+        slot_map_release(&store->handles, handle_slot(id));
+        return -1;
+    }
+    
+    store->count++;
+    store->x[i] = enemy->base.x;
+    store->y[i] = enemy->base.y;
+    store->ai_state[i] = (unsigned char)enemy->ai_state;
+    store->detection_radius[i] = enemy->detection_radius;
+    store->id[i] = id;
+    store->brain[i] = ENEMY_NO_BRAIN;
+    store->health[i] = enemy->base.health;
+    store->faction_id[i] = enemy->faction_id;
+    store->ai_target_id[i] = enemy->ai_target_id;
+    store->behavior_flags[i] = enemy->behavior_flags;
+    store->last_action_time[i] = enemy->last_action_time;
+    store->icon[i] = enemy->base.icon;
+    store->name[i] = enemy->base.name;
+    
+    return i;
+}
+
+/**
+ * Remove the enemy at index; the last enemy takes its place
+ */
+void enemy_store_remove(EnemyStore* store, int index) {
+    if (!store || index < 0 || index >= store->count) return;
+    
+    enemy_store_release_brain(store, index);
+    
+    spatial_remove(&store->grid, handle_slot(store->id[index]), store->x[index], store->y[index]);
+    slot_map_release(&store->handles, handle_slot(store->id[index]));
+    
+    int last = --store->count;
+    if (index == last) return;
+    
+    store->handles.slots[handle_slot(store->id[last])].value = index;
+    store->x[index] = store->x[last];
+    store->y[index] = store->y[last];
+    store->ai_state[index] = store->ai_state[last];
+    store->detection_radius[index] = store->detection_radius[last];
+    store->id[index] = store->id[last];
+    store->brain[index] = store->brain[last];
+    store->health[index] = store->health[last];
+    store->faction_id[index] = store->faction_id[last];
+    store->ai_target_id[index] = store->ai_target_id[last];
+    store->behavior_flags[index] = store->behavior_flags[last];
+    store->last_action_time[index] = store->last_action_time[last];
+    store->icon[index] = store->icon[last];
+    store->name[index] = store->name[last];
+}
+
+/**
+ * Find an enemy's index by handle, or -1 if it's gone
+ * A tile id (no generation bits) matches whoever holds the slot now.
+ */
+int enemy_store_find(const EnemyStore* store, int id) {
+    if (!store) return -1;
+    
+    int slot = slot_map_find(&store->handles, id);
+    return slot < 0 ? -1 : store->handles.slots[slot].value;
+}
+
+/**
+ * Gather the enemy at index into a plain record
+ */
+void enemy_store_get(const EnemyStore* store, int index, AIEnemy* out) {
+    memset(out, 0, sizeof(AIEnemy));
+    out->base.x = store->x[index];
+    out->base.y = store->y[index];
+    out->base.health = store->health[index];
+    out->base.icon = store->icon[index];
+    out->base.name = store->name[index];
+    out->id = store->id[index];
+    out->faction_id = store->faction_id[index];
+    out->ai_state = store->ai_state[index];
+    out->ai_target_id = store->ai_target_id[index];
+    out->detection_radius = store->detection_radius[index];
+    out->behavior_flags = store->behavior_flags[index];
+    out->last_action_time = store->last_action_time[index];
+}
+
+/**
+ * Move the enemy at index, keeping the spatial hash in step
+ * Returns 0, leaving the enemy where it was, if the hash can't grow
+ */
+int enemy_store_move(EnemyStore* store, int index, int x, int y) {
+    if (!spatial_move(&store->grid, handle_slot(store->id[index]),
+                      store->x[index], store->y[index], x, y))
+        return 0;
+    
+    store->x[index] = x;
+    store->y[index] = y;
+    return 1;
+}
+
+/**
+ * An enemy's brain, handed out from the pool on first use
+ * Returns NULL if the pool can't grow
+ */
+EnemyBrain* enemy_store_brain(EnemyStore* store, int index) {
+    if (store->brain[index] != ENEMY_NO_BRAIN) return &store->brains[store->brain[index]];
+    
+    int brain;
+    if (store->free_brain_count > 0) {
+        brain = store->free_brains[--store->free_brain_count];
+    } else {
+        if (store->brain_count == store->brain_capacity) {
+            int capacity = store->brain_capacity ? store->brain_capacity * 2 : 16;
+            if (!resize_array((void**)&store->brains, capacity, sizeof(EnemyBrain)) ||
+                !resize_array((void**)&store->free_brains, capacity, sizeof(int)))
+                return NULL;
+            store->brain_capacity = capacity;
+        }
+        brain = store->brain_count++;
+    }
+    
+    EnemyBrain* result = &store->brains[brain];
+    result->path_length = 0;
+    result->path_index = 0;
+    result->memory_count = 0;
+    store->brain[index] = brain;
+    return result;
+}
+
+/**
+ * Return an enemy's brain to the pool
+ */
+void enemy_store_release_brain(EnemyStore* store, int index) {
+    int brain = store->brain[index];
+    if (brain == ENEMY_NO_BRAIN) return;
+    
+    // free_brains has room for every brain ever handed out
+    store->free_brains[store->free_brain_count++] = brain;
+    store->brain[index] = ENEMY_NO_BRAIN;
+}
+
+/**
+ * Copy every enemy's fields and the slot map into an empty store
+ * Brains and the spatial hash are not copied; the copy is for saving
+ */
+int enemy_store_copy(EnemyStore* dst, const EnemyStore* src) {
+    memset(dst, 0, sizeof(EnemyStore));
+    
+    if (!enemy_store_reserve(dst, src->count) ||
+        !slot_map_copy(&dst->handles, &src->handles)) {
+        enemy_store_clear(dst);
+        return 0;
+    }
+    if (src->count == 0) return 1;
+    
+    size_t n = (size_t)src->count;
+    memcpy(dst->x, src->x, n * sizeof(int));
+    memcpy(dst->y, src->y, n * sizeof(int));
+    memcpy(dst->ai_state, src->ai_state, n * sizeof(unsigned char));
+    memcpy(dst->detection_radius, src->detection_radius, n * sizeof(int));
+    memcpy(dst->id, src->id, n * sizeof(int));
+    memcpy(dst->health, src->health, n * sizeof(int));
+    memcpy(dst->faction_id, src->faction_id, n * sizeof(int));
+    memcpy(dst->ai_target_id, src->ai_target_id, n * sizeof(int));
+    memcpy(dst->behavior_flags, src->behavior_flags, n * sizeof(int));
+    memcpy(dst->last_action_time, src->last_action_time, n * sizeof(int));
+    memcpy(dst->icon, src->icon, n * sizeof(char));
+    memcpy(dst->name, src->name, n * sizeof(char*));
+    for (size_t i = 0; i < n; i++) dst->brain[i] = ENEMY_NO_BRAIN;
+    
+    dst->count = src->count;
+    return 1;
+}
+
+/**
+ * Free every array and reset the store to empty
+ */
+void enemy_store_clear(EnemyStore* store) {
+    free(store->x);
+    free(store->y);
+    free(store->ai_state);
+    free(store->detection_radius);
+    free(store->id);
+    free(store->brain);
+    free(store->health);
+    free(store->faction_id);
+    free(store->ai_target_id);
+    free(store->behavior_flags);
+    free(store->last_action_time);
+    free(store->icon);
+    free(store->name);
+    slot_map_clear(&store->handles);
+    spatial_clear(&store->grid);
+    free(store->brains);
+    free(store->free_brains);
+    memset(store, 0, sizeof(EnemyStore));
+}
@@ -0,0 +1,114 @@
+#ifndef ENEMYSTORE_H
+#define ENEMYSTORE_H
+
+#include <time.h>
+#include "enemy.h"
+#include "slotmap.h"
+#include "spatialhash.h"
+
+/*
+ * Enemies are stored as parallel arrays (structure of arrays), so a pass
+ * over every enemy only pulls in the fields it reads. Paths and memories are
+ * large and only needed while an enemy hunts, so they live in a separate
+ * pool of EnemyBrains, handed out on first use and reused after release.
+ *
+ * Indices are dense and change when an enemy is removed (the last enemy
+ * moves into the gap). Ids are stable handles from a slot map (see
+ * slotmap.h) whose slots hold the enemy's current index. A spatial hash
+ * over the slots answers proximity queries; positions must change through
+ * enemy_store_move to keep it current.
+ */
+
+#define ENEMY_MAX_MEMORIES  10
+#define ENEMY_MAX_PATH      64
+#define ENEMY_NO_BRAIN      (-1)
+
+// One enemy as a plain record, used to add enemies and to save or load them
+typedef struct AIEnemy {
+    enemy base;             // Base enemy structure
+    int id;                 // Handle (0 = assign a new one)
+    int faction_id;         // Which faction this enemy belongs to
+    int ai_state;           // Current AI state (patrolling, hunting, fleeing, etc.)
+    int ai_target_id;       // ID of current target
+    int detection_radius;   // How far this enemy can see
+    int behavior_flags;     // Behavior flags (aggressive, timid, etc.)
+    int last_action_time;   // When the enemy last took an action
+} AIEnemy;
+
+// Something an enemy has seen
+typedef struct EnemyMemory {
+    int entity_id;          // What was seen
+    int x, y;               // Where it was seen
+    time_t time_seen;       // When it was seen
+} EnemyMemory;
+
+// Cold per-enemy AI data, pooled
+typedef struct EnemyBrain {
+    int path[ENEMY_MAX_PATH][2];    // Current path being followed
+    int path_length;                // Length of current path
+    int path_index;                 // Current position in path
+    int memory_count;               // Number of things this enemy remembers
+    EnemyMemory memories[ENEMY_MAX_MEMORIES]; // Memory of things the enemy has seen
+} EnemyBrain;
+
+// All enemies, one array per field
+typedef struct EnemyStore {
+    int count;              // Number of enemies
+    int capacity;           // Allocated length of each array
+    
+    // Hot: read by every enemy every turn
+    int* x;                 // World position
+    int* y;
+    unsigned char* ai_state;        // Current AI state
+    int* detection_radius;  // How far each enemy can see
+    int* id;                // Handle
+    int* brain;             // Index into brains, or ENEMY_NO_BRAIN
+    
+    // Warm: combat, display and saving
+    int* health;
+    int* faction_id;
+    int* ai_target_id;
+    int* behavior_flags;
+    int* last_action_time;
+    char* icon;
+    char** name;
+    
+    // Handle -> index
+    SlotMap handles;
+    
+    // Slots by position
+    SpatialHash grid;
+    
+    // Cold: brain pool
+    EnemyBrain* brains;     // Brain storage
+    int brain_count;        // Brains handed out so far (including free ones)
+    int brain_capacity;     // Allocated brains
+    int* free_brains;       // Released brain indices, reused first
+    int free_brain_count;   // Number of released brains
+} EnemyStore;
+
+// Membership
+int enemy_store_add(EnemyStore* store, const AIEnemy* enemy);
+void enemy_store_remove(EnemyStore* store, int index);
+int enemy_store_find(const EnemyStore* store, int id);
+void enemy_store_get(const EnemyStore* store, int index, AIEnemy* out);
+int enemy_store_move(EnemyStore* store, int index, int x, int y);
+
+// Brains
+EnemyBrain* enemy_store_brain(EnemyStore* store, int index);
+void enemy_store_release_brain(EnemyStore* store, int index);
+
+/**
+ * An enemy's brain, or NULL if it has none yet
+ * The pointer is only valid until the next brain is handed out
+ */
+static inline EnemyBrain* enemy_store_peek_brain(const EnemyStore* store, int index) {
+    int brain = store->brain[index];
+    return brain == ENEMY_NO_BRAIN ? NULL : &store->brains[brain];
+}
+
+// Whole store
+int enemy_store_copy(EnemyStore* dst, const EnemyStore* src);
+void enemy_store_clear(EnemyStore* store);
+
+#endif /* ENEMYSTORE_H */
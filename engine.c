@@ -1,9 +1,7 @@
 #include "engine.h"
+#include "view.h"
+#include "fov.h"
 
-char world[HEIGHT][WIDTH];
-int collisionMap[HEIGHT][WIDTH];
-enemy* enemyList[20];
-int enemyCount = 0;
 inventory playerInventory;
 int turnCount = 0;
 
@@ -14,113 +12,100 @@ void turn(){
 
 void clearscreen()
 {
-    HANDLE hOut;
-    COORD Position;
-
-    hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-
-    Position.X = 0;
-    Position.Y = 0;
-    SetConsoleCursorPosition(hOut, Position);
+    platform_cursor_home();
 }
 
-void drawMap(int playerX, int playerY){
-    clearscreen();
-    printf("\033[93m                Valdmir!\n");
-    printf("\033[96mItems: \n");
-    printf("Enemy Count: %d\n", enemyCount); //Debug
+void drawMap(GameState* state){
+    int row = 0;
+    View view;
+    view_follow_player(state, &view, WIDTH, HEIGHT);
+    update_fov(state);
+
+    render_begin();
+    render_text(row++, 0, COLOR_FG_BRIGHT_YELLOW, COLOR_BG_BLACK, "                Valdmir!");
+    render_text(row++, 0, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "Items: ");
+    render_text(row++, 0, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "Enemy Count: %d", state->enemies.count); //Debug
     //show inventory items
+    int col = 0;
     for(int i=0; i<playerInventory.size; i++){
-        printf("%s", (char*)(playerInventory.contents->icon));
+        col += render_text(row, col, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "%s", (char*)(playerInventory.contents->icon));
     }
-    printf("\n");
+    render_text(row++, col, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "");
+
+    // Draw the game world, two columns per tile
+    for (int y = 0; y < view.height; y++, row++) {
+        for (int x = 0; x < view.width; x++) {
+            ViewCell cell = view_cell(state, view.origin_x + x, view.origin_y + y);
+            int fg = COLOR_FG_DEFAULT;
+            int bg = cell.tile == TILE_WALL ? COLOR_BG_GREY :
+                     cell.tile == TILE_EMPTY ? COLOR_BG_BLACK : COLOR_BG_WHITE;
+            char glyph = ' ';
+
+            // Remembered tiles are drawn dimmed on black, unseen ones not at all
+            if(cell.visibility == VIEW_UNSEEN){
+                bg = COLOR_BG_BLACK;
+            } else if(cell.visibility == VIEW_REMEMBERED){
+                fg = COLOR_FG_GREY;
+                bg = COLOR_BG_BLACK;
+                glyph = cell.kind == VIEW_ITEM ? cell.glyph :
+                        cell.tile == TILE_WALL ? '#' :
+                        cell.tile == TILE_EMPTY ? ' ' : '.';
+                cell.kind = VIEW_NOTHING;
+            }
 
-    // Draw the game world
-    for (int x = 0; x < HEIGHT; x++) {
-        for (int y = 0; y < WIDTH; y++) {
-            if(world[x][y] == '@')                          // Player
-                printf("\033[33m%c ", world[x][y]);
-            if(world[x][y] == 'w')                          // Wall
-                printf("\033[100m  \033[40m");
-            if(world[x][y] == '.')                          // Walkable Floor
-                printf("\033[47m  ");
-            if(world[x][y] == 'G')
-                printf("\033[92mG ");
+            switch(cell.kind){
+                case VIEW_PLAYER:                           // Player
+                    fg = COLOR_FG_YELLOW;
+                    glyph = '@';
+                    break;
+                case VIEW_ENEMY:
+                    fg = COLOR_FG_BRIGHT_GREEN;
+                    glyph = cell.glyph;
+                    break;
+                case VIEW_ITEM:
+                    fg = COLOR_FG_BRIGHT_YELLOW;
+                    glyph = cell.glyph;
+                    break;
+                default:                                    // Terrain, or nothing to show
+                    break;
+            }
+            render_put(row, x * 2, glyph, fg, bg);
+            render_put(row, x * 2 + 1, ' ', fg, bg);
         }
-        printf("\n\033[40m");
     }
-    printf("Enemy List: \n");
-    for(int i=0; i < enemyCount; i++)
-        printf("%s\n", enemyList[i]->name);
+
+    // Only the enemies in sight are listed
+    int inSight[ENEMY_LIST_ROWS];
+    int found = view_enemies(state, &view, inSight, ENEMY_LIST_ROWS);
+    render_text(row++, 0, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "Enemy List: ");
+    for(int i=0; i < found && i < ENEMY_LIST_ROWS; i++)
+        render_text(row++, 0, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "%s", state->enemies.name[inSight[i]]);
+    if(found > ENEMY_LIST_ROWS)
+        render_text(row++, 0, COLOR_FG_BRIGHT_CYAN, COLOR_BG_BLACK, "... and %d more", found - ENEMY_LIST_ROWS);
+
+    // Only the cells that changed reach the terminal
+    render_present();
 }
 
 void initColor(){
-    //Sets up Color
-    system("setup.bat");
-    system("cls");
+    //Sets up Color and raw keyboard input
+    platform_init_terminal();
+    platform_clear_screen();
+    render_invalidate();
 }
 
-void generateCollisionFile(){ //debug
+void generateCollisionFile(GameState* state){ //debug, dumps the page on screen
+    View view;
+    view_follow_player(state, &view, WIDTH, HEIGHT);
     FILE *collisions;
     collisions = fopen("collisions.txt","w");
-    for (int i = 0; i < HEIGHT; i++) {
-        for (int j = 0; j < WIDTH; j++) {
-            fprintf(collisions, "%d ", collisionMap[i][j]);
+    if(collisions == NULL)
+        return;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            fprintf(collisions, "%d ", is_walkable_world(state, view.origin_x + x, view.origin_y + y) ? 0 : 1);
         }
         fprintf(collisions, "\n");
     }
     fclose(collisions);
 }
-
-void generateCollisionMap(FILE* fptr){
-    char c;
-    rewind(fptr);
-    for (int x = 0; x < HEIGHT; x++) {
-        for (int y = 0; y < WIDTH; y++) {
-            c = fgetc(fptr);
-            if(c == 'w')
-                collisionMap[x][y] = 1;
-            if(c == '0')
-                collisionMap[x][y] = 0;
-            if(c == 'G')
-                collisionMap[x][y] = 1;
-        }
-    }
-    generateCollisionFile(); //debug
-}
-
-void initEnemy(char type, int x, int y){
-    if(type == 'G'){
-        enemy* Goblin;
-        Goblin = (enemy*)malloc(sizeof(enemy));
-        Goblin->x = x;
-        Goblin->y = y;
-        Goblin->icon = 'G';
-        //strcpy(Goblin->name, "Goblin");
-        char* gName = "Goblin";
-        Goblin->name = gName;
-        enemyCount++;
-        enemyList[enemyCount-1] = Goblin;
-    }
-        
-}
-
-void initLevel(FILE* fptr){
-    char c;
-    enemyCount = 0;
-    for (int x = 0; x < HEIGHT; x++) {
-        for (int y = 0; y < WIDTH; y++) {
-            c = fgetc(fptr);
-            if(c == 'w')
-                world[x][y] = 'w';
-            if(c == '0')
-                world[x][y] = '.';
-            if(c == 'G'){
-                world[x][y] = 'G';
-                initEnemy('G', x, y);
-            }
-                
-        }
-    }
-    generateCollisionMap(fptr);
-}
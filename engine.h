@@ -3,18 +3,18 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <conio.h>
 #include <string.h>
-#include <Windows.h>
 #include "enemy.h"
+#include "platform.h"
+#include "render.h"
+#include "gamestate.h"
 
+// Size of the map shown on screen, in tiles
 #define HEIGHT 14
 #define WIDTH 20
 
-extern char world[HEIGHT][WIDTH];
-extern int collisionMap[HEIGHT][WIDTH];
-extern enemy* enemyList[20];
-extern int enemyCount;
+// How many enemy names fit under the map
+#define ENEMY_LIST_ROWS 10
 
 typedef struct player{
     int health;
@@ -41,11 +41,8 @@ extern int turnCount;
 // Function prototypes
 void turn();
 void clearscreen();
-void drawMap(int playerX, int playerY);
+void drawMap(GameState* state);
 void initColor();
-void generateCollisionFile();
-void generateCollisionMap(FILE* fptr);
-void initEnemy(char type, int x, int y);
-void initLevel(FILE* fptr);
+void generateCollisionFile(GameState* state);
 
 #endif /* ENGINE_H */
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "flowfield.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Get the flow field stored on a chunk, allocating it on first use
+ */
+static FlowField* get_flow_field(WorldChunk* chunk, int width, int height) {
+    FlowField* field = chunk->flow_field;
+    if (field && field->width == width && field->height == height)
+        return field;
+
+    free_flow_field(field);
+    chunk->flow_field = NULL;
+
+    int tiles = width * height;
+    int row_words = BITS_ROW_WORDS(width);
+    size_t grid_words = (size_t)row_words * height;
+
+    field = (FlowField*)calloc(1, sizeof(FlowField));
+    if (!field) return NULL;
+
+    field->width = width;
+    field->height = height;
+    field->row_words = row_words;
+    field->distance = (unsigned short*)malloc(tiles * sizeof(unsigned short));
+    field->walkable = (uint64_t*)malloc(4 * grid_words * sizeof(uint64_t));
+
+    if (!field->distance || !field->walkable) {
+        free_flow_field(field);
+        return NULL;
+    }
+    field->reached = field->walkable + grid_words;
+    field->frontier = field->reached + grid_words;
+    field->next = field->frontier + grid_words;
+
+    chunk->flow_field = field;
+    return field;
+}
+
+/**
+ * Free a flow field
+ */
+void free_flow_field(FlowField* field) {
+    if (!field) return;
+
+    free(field->distance);
+    free(field->walkable);
+    free(field);
+}
+
+/**
+ * Check if a world position lies inside a flow field
+ */
+int flow_field_contains(const FlowField* field, int x, int y) {
+    if (!field || !field->valid) return 0;
+
+    x -= field->window_x;
+    y -= field->window_y;
+    return x >= 0 && y >= 0 && x < field->width && y < field->height;
+}
+
+/**
+ * Combine the walk versions of a window's chunks
+ * Versions only grow and a newly loaded chunk adds at least one, so any
+ * walkability change inside the window changes the sum.
+ */
+static unsigned int window_walk_version(const ChunkWindow* window) {
+    unsigned int version = 0;
+
+    for (int i = 0; i < 9; i++) {
+        if (window->chunks[i]) version += window->chunks[i]->walk_version + 1;
+    }
+
+    return version;
+}
+
+/**
+ * Bring the flow field around a world position up to date
+ * The field lives on the chunk containing the origin and is only rebuilt
+ * when the origin moved or walkability inside its window changed, so
+ * calling this every turn is cheap.
+ */
+FlowField* update_flow_field(GameState* state, int origin_x, int origin_y) {
+    if (!state) return NULL;
+
+    int local_x, local_y;
+    WorldChunk* home = get_chunk_for_world(state, origin_x, origin_y, &local_x, &local_y);
+    if (!home) return NULL;
+
+    ChunkWindow window;
+    get_chunk_window(state, home->x, home->y, &window);
+
+    FlowField* field = get_flow_field(home, window.width, window.height);
+    if (!field) return NULL;
+
+    unsigned int version = window_walk_version(&window);
+    if (field->valid && field->origin_x == origin_x && field->origin_y == origin_y &&
+        field->walk_version == version) {
+        return field;
+    }
+
+    int width = field->width;
+    int height = field->height;
+
+    field->window_x = window.origin_x;
+    field->window_y = window.origin_y;
+    field->origin_x = origin_x;
+    field->origin_y = origin_y;
+    field->walk_version = version;
+    field->valid = 1;
+
+    // 0xFF bytes give FLOW_UNREACHABLE in every entry
+    memset(field->distance, 0xFF, width * height * sizeof(unsigned short));
+
+    // Stitch the chunks' walkable rows into one bit grid for the window
+    int row_words = field->row_words;
+    size_t grid_words = (size_t)row_words * height;
+    memset(field->walkable, 0, grid_words * sizeof(uint64_t));
+    for (int i = 0; i < 9; i++) {
+        const TilePlanes* planes = window.planes[i];
+        if (!planes) continue;
+
+        int offset_x = (i % 3) * window.chunk_width;
+        int offset_y = (i / 3) * window.chunk_height;
+        for (int y = 0; y < window.chunk_height; y++) {
+            bits_copy(field->walkable + (size_t)(offset_y + y) * row_words, offset_x,
+                      plane_row(planes, PLANE_WALKABLE, y), window.chunk_width);
+        }
+    }
+
+    // Uniform step costs, so Dijkstra reduces to a breadth-first flood,
+    // grown one whole ring of tiles per step
+    int origin_x_local = origin_x - window.origin_x;
+    int origin_y_local = origin_y - window.origin_y;
+    size_t origin_word = (size_t)origin_y_local * row_words + (origin_x_local >> 6);
+
+    memset(field->reached, 0, grid_words * sizeof(uint64_t));
+    memset(field->frontier, 0, grid_words * sizeof(uint64_t));
+    field->reached[origin_word] = field->frontier[origin_word] = (uint64_t)1 << (origin_x_local & 63);
+    field->distance[origin_y_local * width + origin_x_local] = 0;
+
+    // Only the rows the frontier spans are touched
+    int first_row = origin_y_local;
+    int last_row = origin_y_local;
+    for (unsigned short step = 1; step < FLOW_UNREACHABLE; step++) {
+        if (!bits_flood_step(field->walkable, field->reached, field->frontier, field->next,
+                             row_words, height, &first_row, &last_row)) {
+            break;
+        }
+
+        // Stamp the distance of every tile the step reached
+        for (int y = first_row; y <= last_row; y++) {
+            const uint64_t* row = field->next + (size_t)y * row_words;
+            for (int i = 0; i < row_words; i++) {
+                for (uint64_t word = row[i]; word; word &= word - 1) {
+                    field->distance[y * width + i * 64 + bits_lowest(word)] = step;
+                }
+            }
+        }
+
+        uint64_t* swap = field->frontier;
+        field->frontier = field->next;
+        field->next = swap;
+    }
+
+    return field;
+}
@@ -0,0 +1,30 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "gamestate.h"
+
+// Distance value for tiles the player can't be reached from
+#define FLOW_UNREACHABLE 0xFFFF
+
+// Dijkstra map toward the player shared by every chasing enemy nearby
+// Covers the 3x3 chunks around the chunk holding the origin.
+typedef struct FlowField {
+    int width, height;          // Dimensions of the field (the chunk window)
+    int window_x, window_y;     // World position of the field's top-left tile
+    int origin_x, origin_y;     // World position the distances are measured from
+    unsigned int walk_version;  // Combined walk_version of the window's chunks at build time
+    int valid;                  // Whether the field has been computed
+    unsigned short* distance;   // Steps to the origin for each tile
+    int row_words;              // 64-bit words per row of the bit grids below
+    uint64_t* walkable;         // Walkable tiles of the window, one bit each
+    uint64_t* reached;          // Tiles the flood has reached
+    uint64_t* frontier;         // Tiles reached by the last step
+    uint64_t* next;             // Tiles reached by the current step
+} FlowField;
+
+// Flow field API
+FlowField* update_flow_field(GameState* state, int origin_x, int origin_y);
+int flow_field_contains(const FlowField* field, int x, int y);
+void free_flow_field(FlowField* field);
+
+#endif /* FLOWFIELD_H */
@@ -0,0 +1,208 @@
+#include "fov.h"
+#include <stdlib.h>
+#include <string.h>
+
+// A slope num/den (den > 0) measured from the origin along a quadrant's rows
+typedef struct Slope {
+    int num, den;
+} Slope;
+
+// One field of view computation
+typedef struct FovScan {
+    GameState* state;
+    int origin_x, origin_y; // Where the player stands
+    int radius;             // Sight radius in tiles
+    int quadrant;           // 0 north, 1 east, 2 south, 3 west
+    unsigned int stamp;     // Stamp of this computation
+} FovScan;
+
+/**
+ * Get the visibility bits of a chunk, allocating them on first use
+ */
+static ChunkFov* get_chunk_fov(WorldChunk* chunk) {
+    if (chunk->fov) return chunk->fov;
+
+    int words = (chunk->width * chunk->height + 63) / 64;
+    ChunkFov* fov = (ChunkFov*)calloc(1, sizeof(ChunkFov) + 2 * (size_t)words * sizeof(uint64_t));
+    if (!fov) return NULL;
+
+    fov->words = words;
+    fov->visible = (uint64_t*)(fov + 1);
+    fov->explored = fov->visible + words;
+    chunk->fov = fov;
+    return fov;
+}
+
+/**
+ * Free a chunk's visibility bits
+ */
+void free_chunk_fov(ChunkFov* fov) {
+    free(fov);
+}
+
+/**
+ * Mark a world position visible and explored
+ */
+static void reveal(const FovScan* scan, int x, int y) {
+    int local_x, local_y;
+    WorldChunk* chunk = get_chunk_for_world(scan->state, x, y, &local_x, &local_y);
+    if (!chunk) return;
+
+    ChunkFov* fov = get_chunk_fov(chunk);
+    if (!fov) return;
+
+    // Bits left over from an older computation are cleared on first touch
+    if (fov->stamp != scan->stamp) {
+        memset(fov->visible, 0, (size_t)fov->words * sizeof(uint64_t));
+        fov->stamp = scan->stamp;
+    }
+
+    int bit = local_y * chunk->width + local_x;
+    fov->visible[bit >> 6] |= (uint64_t)1 << (bit & 63);
+    fov->explored[bit >> 6] |= (uint64_t)1 << (bit & 63);
+}
+
+/**
+ * Whether a world position blocks sight (unloaded positions do)
+ */
+static int is_opaque(GameState* state, int x, int y) {
+    int local_x, local_y;
+    WorldChunk* chunk = get_chunk_for_world(state, x, y, &local_x, &local_y);
+    if (!chunk) return 1;
+
+    TilePlanes* planes = chunk_planes(chunk);
+    if (!planes) return !tile_transparent(CHUNK_TILE(chunk, local_x, local_y));
+
+    return !plane_test(planes, PLANE_TRANSPARENT, local_x, local_y);
+}
+
+/**
+ * Map a quadrant row/column to a world position
+ */
+static void quadrant_to_world(const FovScan* scan, int depth, int col, int* x, int* y) {
+    switch (scan->quadrant) {
+        case 0: *x = scan->origin_x + col;   *y = scan->origin_y - depth; break;
+        case 1: *x = scan->origin_x + depth; *y = scan->origin_y + col;   break;
+        case 2: *x = scan->origin_x + col;   *y = scan->origin_y + depth; break;
+        default: *x = scan->origin_x - depth; *y = scan->origin_y + col;  break;
+    }
+}
+
+/**
+ * Floor division for a positive divisor
+ */
+static int floor_div(int value, int divisor) {
+    int quotient = value / divisor;
+    if (value % divisor < 0) quotient--;
+    return quotient;
+}
+
+/**
+ * Scan one row of a quadrant between two slopes, then the rows behind it
+ * A floor tile is only revealed when its centre lies inside the slopes, which
+ * keeps visibility symmetric; walls are revealed when any part is in view.
+ */
+static void scan_row(const FovScan* scan, int depth, Slope start, Slope end) {
+    if (depth > scan->radius) return;
+
+    // Columns whose centres round into [depth * start, depth * end]
+    int min_col = floor_div(2 * depth * start.num + start.den, 2 * start.den);
+    int max_col = -floor_div(end.den - 2 * depth * end.num, 2 * end.den);
+    int limit = scan->radius * scan->radius + scan->radius;
+    int prev_opaque = -1;
+
+    for (int col = min_col; col <= max_col; col++) {
+        int x, y;
+        quadrant_to_world(scan, depth, col, &x, &y);
+        int opaque = is_opaque(scan->state, x, y);
+
+        int symmetric = col * start.den >= depth * start.num && col * end.den <= depth * end.num;
+        if ((opaque || symmetric) && depth * depth + col * col <= limit) {
+            reveal(scan, x, y);
+        }
+
+        // The left edge of this tile bounds what is seen past it
+        Slope edge = { 2 * col - 1, 2 * depth };
+        if (prev_opaque == 1 && !opaque) {
+            start = edge;
+        }
+        if (prev_opaque == 0 && opaque) {
+            scan_row(scan, depth + 1, start, edge);
+        }
+        prev_opaque = opaque;
+    }
+
+    if (prev_opaque == 0) {
+        scan_row(scan, depth + 1, start, end);
+    }
+}
+
+/**
+ * Recompute what the player can see, unless nothing has changed since last time
+ */
+void update_fov(GameState* state) {
+    if (!state) return;
+
+    World* world = &state->world;
+    if (world->fov_stamp != 0 &&
+        world->fov_x == state->player.x && world->fov_y == state->player.y &&
+        world->fov_terrain == world->terrain_version) {
+        return;
+    }
+
+    // Zero means "never computed"
+    if (++world->fov_stamp == 0) world->fov_stamp = 1;
+    world->fov_x = state->player.x;
+    world->fov_y = state->player.y;
+    world->fov_terrain = world->terrain_version;
+
+    FovScan scan;
+    scan.state = state;
+    scan.origin_x = state->player.x;
+    scan.origin_y = state->player.y;
+    scan.radius = FOV_RADIUS;
+    scan.stamp = world->fov_stamp;
+
+    reveal(&scan, scan.origin_x, scan.origin_y);
+
+    Slope start = { -1, 1 };
+    Slope end = { 1, 1 };
+    for (scan.quadrant = 0; scan.quadrant < 4; scan.quadrant++) {
+        scan_row(&scan, 1, start, end);
+    }
+}
+
+/**
+ * Look up one of a position's visibility bits without decoding its chunk
+ */
+static int fov_bit(GameState* state, int x, int y, int explored) {
+    if (!state) return 0;
+
+    int chunk_x, chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, x, y, &chunk_x, &chunk_y, &local_x, &local_y);
+    int index = get_chunk_index(state, chunk_x, chunk_y);
+    if (index < 0) return 0;
+
+    WorldChunk* chunk = state->world.chunks[index];
+    ChunkFov* fov = chunk->fov;
+    if (!fov) return 0;
+    if (!explored && fov->stamp != state->world.fov_stamp) return 0;
+
+    int bit = local_y * chunk->width + local_x;
+    const uint64_t* bits = explored ? fov->explored : fov->visible;
+    return (int)((bits[bit >> 6] >> (bit & 63)) & 1);
+}
+
+/**
+ * Whether the player currently sees a world position
+ */
+int fov_visible(GameState* state, int x, int y) {
+    return fov_bit(state, x, y, 0);
+}
+
+/**
+ * Whether the player has ever seen a world position
+ */
+int fov_explored(GameState* state, int x, int y) {
+    return fov_bit(state, x, y, 1);
+}
@@ -0,0 +1,26 @@
+#ifndef FOV_H
+#define FOV_H
+
+#include <stdint.h>
+#include "gamestate.h"
+
+// How far the player can see; enemies can't notice the player from further away
+#define FOV_RADIUS 8
+
+// Player visibility for one chunk, one bit per tile in row-major order
+// Recomputed by symmetric shadowcasting: if a tile can see the player, the
+// player can see the tile, so enemy detection is a lookup into these bits.
+typedef struct ChunkFov {
+    unsigned int stamp;     // World fov_stamp the visible bits belong to
+    int words;              // Length of each bitmap in 64-bit words
+    uint64_t* visible;      // In view since the last recompute
+    uint64_t* explored;     // Ever seen (remembered tiles)
+} ChunkFov;
+
+// Field of view API
+void update_fov(GameState* state);
+int fov_visible(GameState* state, int x, int y);
+int fov_explored(GameState* state, int x, int y);
+void free_chunk_fov(ChunkFov* fov);
+
+#endif /* FOV_H */
@@ -1,11 +1,26 @@
 #include "gamestate.h"
-#include "engine.h"
+#include "pathfinding.h"
+#include "flowfield.h"
+#include "fov.h"
+#include "scheduler.h"
+#include "savegame.h"
+#include "chunkpack.h"
+#include "platform.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
 #include <stdarg.h>  // For va_list
+#ifdef _WIN32
+#include <malloc.h>  // For _aligned_malloc
+#endif
+
+// Internal helpers
+static void chunk_index_insert(World* world, int index);
+static WorldTile* edit_tile_world(GameState* state, int x, int y);
+static void make_chunk_dormant(World* world, WorldChunk* chunk);
+static int move_enemy(GameState* state, int index, int new_x, int new_y);
 
 // Initialization functions
 
@@ -39,8 +54,7 @@ void init_world(GameState* state, int width, int height, int seed) {
     
     // Set world properties
     state->world.seed = seed;
-    state->world.chunk_width = width;
-    state->world.chunk_height = height;
+    set_chunk_size(&state->world, width, height);
     state->world.current_chunk_x = 0;
     state->world.current_chunk_y = 0;
     state->world.turn_counter = 0;
@@ -50,29 +64,106 @@ void init_world(GameState* state, int width, int height, int seed) {
     // Create initial chunk
     state->world.chunk_count = 1;
     state->world.chunks = (WorldChunk**)malloc(sizeof(WorldChunk*));
-    state->world.chunks[0] = (WorldChunk*)malloc(sizeof(WorldChunk));
+    state->world.chunks[0] = create_chunk(0, 0, width, height);
     
     WorldChunk* chunk = state->world.chunks[0];
-    chunk->x = 0;
-    chunk->y = 0;
+    if (!chunk) return;
+    rebuild_chunk_index(&state->world);
+    
+    // Initialize tiles
+    for (int i = 0; i < width * height; i++) {
+        init_tile(&chunk->tiles[i], TILE_FLOOR);
+    }
+}
+
+/**
+ * Set chunk dimensions and precompute shifts for world coordinate mapping
+ */
+void set_chunk_size(World* world, int width, int height) {
+    if (!world) return;
+    
+    world->chunk_width = width;
+    world->chunk_height = height;
+    world->chunk_shift_x = -1;
+    world->chunk_shift_y = -1;
+    
+    // Powers of two map with shift/mask instead of division
+    for (int shift = 0; shift < 31; shift++) {
+        if ((1 << shift) == width) world->chunk_shift_x = shift;
+        if ((1 << shift) == height) world->chunk_shift_y = shift;
+    }
+}
+
+/**
+ * Allocate a chunk with zeroed, cache-line aligned tile storage
+ */
+WorldChunk* create_chunk(int chunk_x, int chunk_y, int width, int height) {
+    WorldChunk* chunk = (WorldChunk*)calloc(1, sizeof(WorldChunk));
+    if (!chunk) return NULL;
+    
+    chunk->x = chunk_x;
+    chunk->y = chunk_y;
     chunk->width = width;
     chunk->height = height;
     chunk->active = 1;
     chunk->last_updated = time(NULL);
     
-    // Initialize tiles
-    chunk->tiles = (WorldTile**)malloc(height * sizeof(WorldTile*));
-    for (int y = 0; y < height; y++) {
-        chunk->tiles[y] = (WorldTile*)malloc(width * sizeof(WorldTile));
-        for (int x = 0; x < width; x++) {
-            chunk->tiles[y][x].type = TILE_FLOOR;
-            chunk->tiles[y][x].display_char = '.';
-            chunk->tiles[y][x].walkable = 1;
-            chunk->tiles[y][x].transparent = 1;
-            chunk->tiles[y][x].entity_id = 0;
-            chunk->tiles[y][x].item_id = 0;
-        }
+    if (!alloc_chunk_tiles(chunk)) {
+        free(chunk);
+        return NULL;
     }
+    
+    return chunk;
+}
+
+/**
+ * Free a chunk and everything it owns
+ */
+void destroy_chunk(WorldChunk* chunk) {
+    if (!chunk) return;
+    
+    free_chunk_tiles(chunk);
+    free_packed_tiles(chunk);
+    free_path_buffers(chunk->path_buffers);
+    free_flow_field(chunk->flow_field);
+    free_chunk_fov(chunk->fov);
+    free_tile_planes(chunk->planes);
+    free(chunk->sim_before);
+    free(chunk);
+}
+
+/**
+ * Allocate zeroed tile storage for a chunk, rounded up to whole cache lines
+ */
+int alloc_chunk_tiles(WorldChunk* chunk) {
+    size_t size = (size_t)chunk->width * chunk->height * sizeof(WorldTile);
+    size = (size + CHUNK_TILE_ALIGNMENT - 1) & ~(size_t)(CHUNK_TILE_ALIGNMENT - 1);
+    if (size == 0) size = CHUNK_TILE_ALIGNMENT;
+    
+#ifdef _WIN32
+    chunk->tiles = (WorldTile*)_aligned_malloc(size, CHUNK_TILE_ALIGNMENT);
+#else
+    void* tiles = NULL;
+    if (posix_memalign(&tiles, CHUNK_TILE_ALIGNMENT, size) != 0) tiles = NULL;
+    chunk->tiles = (WorldTile*)tiles;
+#endif
+    if (!chunk->tiles) return 0;
+    
+    memset(chunk->tiles, 0, size);
+    invalidate_chunk_planes(chunk);
+    return 1;
+}
+
+/**
+ * Free a chunk's tile storage
+ */
+void free_chunk_tiles(WorldChunk* chunk) {
+#ifdef _WIN32
+    _aligned_free(chunk->tiles);
+#else
+    free(chunk->tiles);
+#endif
+    chunk->tiles = NULL;
 }
 
 /**
@@ -81,14 +172,13 @@ void init_world(GameState* state, int width, int height, int seed) {
 void load_chunk(GameState* state, int chunk_x, int chunk_y) {
     if (!state) return;
     
-    // Check if chunk already exists
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        if (state->world.chunks[i]->x == chunk_x && state->world.chunks[i]->y == chunk_y) {
-            state->world.chunks[i]->active = 1;
-            state->world.current_chunk_x = chunk_x;
-            state->world.current_chunk_y = chunk_y;
-            return;
-        }
+    // Check if chunk already exists (decoding it from the save if needed)
+    WorldChunk* existing = get_chunk_at(state, chunk_x, chunk_y);
+    if (existing) {
+        existing->active = 1;
+        state->world.current_chunk_x = chunk_x;
+        state->world.current_chunk_y = chunk_y;
+        return;
     }
     
     // Create new chunk
@@ -97,41 +187,35 @@ void load_chunk(GameState* state, int chunk_x, int chunk_y) {
                                                state->world.chunk_count * sizeof(WorldChunk*));
     
     int index = state->world.chunk_count - 1;
-    state->world.chunks[index] = (WorldChunk*)malloc(sizeof(WorldChunk));
+    state->world.chunks[index] = create_chunk(chunk_x, chunk_y,
+                                              state->world.chunk_width,
+                                              state->world.chunk_height);
     
     WorldChunk* chunk = state->world.chunks[index];
-    chunk->x = chunk_x;
-    chunk->y = chunk_y;
-    chunk->width = state->world.chunk_width;
-    chunk->height = state->world.chunk_height;
-    chunk->active = 1;
-    chunk->last_updated = time(NULL);
+    if (!chunk) {
+        state->world.chunk_count--;
+        return;
+    }
+    chunk_index_insert(&state->world, index);
+    chunk->dirty = 1; // Not in any save yet
     
     // Initialize tiles with procedural generation
-    chunk->tiles = (WorldTile**)malloc(chunk->height * sizeof(WorldTile*));
+    // Each tile hashes its own world position, so chunks come out the same in any load order
+    uint64_t seed = (uint32_t)state->world.seed;
+    int origin_x = chunk_x * chunk->width;
+    int origin_y = chunk_y * chunk->height;
     for (int y = 0; y < chunk->height; y++) {
-        chunk->tiles[y] = (WorldTile*)malloc(chunk->width * sizeof(WorldTile));
         for (int x = 0; x < chunk->width; x++) {
-            // Basic procedural generation using seed
-            int value = (x * 7 + y * 13 + state->world.seed + chunk_x * 31 + chunk_y * 47) % 100;
-            
-            if (value < 70) {
-                chunk->tiles[y][x].type = TILE_FLOOR;
-                chunk->tiles[y][x].display_char = '.';
-                chunk->tiles[y][x].walkable = 1;
-                chunk->tiles[y][x].transparent = 1;
-            } else {
-                chunk->tiles[y][x].type = TILE_WALL;
-                chunk->tiles[y][x].display_char = 'w';
-                chunk->tiles[y][x].walkable = 0;
-                chunk->tiles[y][x].transparent = 0;
-            }
+            int value = (int)(rng_hash(seed, RNG_DOMAIN_CHUNK, origin_x + x, origin_y + y) % 100);
             
-            chunk->tiles[y][x].entity_id = 0;
-            chunk->tiles[y][x].item_id = 0;
+            init_tile(CHUNK_TILE(chunk, x, y), value < 70 ? TILE_FLOOR : TILE_WALL);
         }
     }
     
+    // Cells that were missing now have walls and floor; views computed
+    // across them are stale
+    state->world.terrain_version++;
+    
     // Set as current chunk
     state->world.current_chunk_x = chunk_x;
     state->world.current_chunk_y = chunk_y;
@@ -139,268 +223,69 @@ void load_chunk(GameState* state, int chunk_x, int chunk_y) {
 
 /**
  * Unload a chunk to save memory (doesn't delete it)
+ * Chunks backed by a mapped save drop their decoded tiles if unchanged;
+ * others are kept packed until the chunk is touched again.
  */
 void unload_chunk(GameState* state, int chunk_x, int chunk_y) {
     if (!state) return;
     
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        if (state->world.chunks[i]->x == chunk_x && state->world.chunks[i]->y == chunk_y) {
-            state->world.chunks[i]->active = 0;
-            state->world.chunks[i]->last_updated = time(NULL);
-            return;
-        }
-    }
+    int index = get_chunk_index(state, chunk_x, chunk_y);
+    if (index < 0) return;
+    
+    WorldChunk* chunk = state->world.chunks[index];
+    chunk->active = 0;
+    chunk->last_updated = time(NULL);
+    make_chunk_dormant(&state->world, chunk);
+    if (state->world.last_chunk == chunk) state->world.last_chunk = NULL;
 }
 
-// Game state management
-
 /**
- * Save the game to a file
+ * Drop a chunk's decoded tiles: released if the mapped save still holds
+ * them, packed otherwise. They are decoded again on first touch.
  */
-int save_game(GameState* state, const char* filename) {
-    if (!state || !filename) return 0;
-    
-    FILE* file = fopen(filename, "wb");
-    if (!file) return 0;
-    
-    // Write header
-    fprintf(file, "ROGUELIKE_SAVE_v1\n");
-    
-    // Write player data
-    fprintf(file, "PLAYER\n");
-    fprintf(file, "%d %d %d %d %d %d %s\n", 
-            state->player.x, state->player.y,
-            state->player.health, state->player.max_health,
-            state->player.strength, state->player.level,
-            state->player.name);
-    
-    // Write world data
-    fprintf(file, "WORLD\n");    fprintf(file, "%s %d %d %d %d %lld\n",
-            state->world.name, state->world.chunk_count,
-            state->world.chunk_width, state->world.chunk_height,
-            state->world.seed, state->world.world_time);
-    
-    // Write chunk data
-    fprintf(file, "CHUNKS\n");
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        WorldChunk* chunk = state->world.chunks[i];        fprintf(file, "CHUNK %d %d %d %d %d %lld\n",
-                chunk->x, chunk->y, chunk->width, chunk->height,
-                chunk->active, chunk->last_updated);
-        
-        // Write all tiles in chunk
-        for (int y = 0; y < chunk->height; y++) {
-            for (int x = 0; x < chunk->width; x++) {
-                WorldTile* tile = &chunk->tiles[y][x];
-                fprintf(file, "%d %c %d %d %d %d\n",
-                        tile->type, tile->display_char,
-                        tile->walkable, tile->transparent,
-                        tile->entity_id, tile->item_id);
-            }
-        }
-    }
-    
-    // Write enemy data
-    fprintf(file, "ENEMIES %d\n", state->enemy_count);
-    for (int i = 0; i < state->enemy_count; i++) {
-        AIEnemy* enemy = &state->enemies[i];
-        fprintf(file, "%d %d %d %d %d %d %d %d\n",
-                enemy->id, enemy->base.x, enemy->base.y,
-                enemy->base.health, enemy->faction_id,
-                enemy->ai_state, enemy->detection_radius,
-                enemy->behavior_flags);
-    }
-    
-    // Write item data
-    fprintf(file, "ITEMS %d\n", state->item_count);
-    for (int i = 0; i < state->item_count; i++) {
-        GameItem* item = &state->items[i];
-        fprintf(file, "%s %c %d %f %d\n",
-                item->name, item->icon,
-                item->value, item->weight, item->type);
-    }
-    
-    // Write end marker
-    fprintf(file, "END\n");
-    
-    fclose(file);
-    printf("Game saved to %s\n", filename);
-    return 1;
+static void make_chunk_dormant(World* world, WorldChunk* chunk) {
+    release_chunk_tiles(world, chunk);
+    if (chunk->tiles) pack_chunk(chunk);
+    
+    // Search buffers and tile planes are rebuilt on demand
+    free_path_buffers(chunk->path_buffers);
+    chunk->path_buffers = NULL;
+    free_flow_field(chunk->flow_field);
+    chunk->flow_field = NULL;
+    free_tile_planes(chunk->planes);
+    chunk->planes = NULL;
+    free(chunk->sim_before);
+    chunk->sim_before = NULL;
 }
 
 /**
- * Load the game from a file
+ * Make every decoded chunk in the frozen tier dormant
+ * Only runs when the player has entered another chunk
  */
-int load_game(GameState* state, const char* filename) {
-    if (!state || !filename) return 0;
-    
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        printf("Could not open save file: %s\n", filename);
-        return 0;
-    }
-    
-    char buffer[256];
-    
-    // Read and check header
-    if (!fgets(buffer, sizeof(buffer), file) || 
-        strncmp(buffer, "ROGUELIKE_SAVE", 14) != 0) {
-        printf("Invalid save file format\n");
-        fclose(file);
-        return 0;
+static void pack_dormant_chunks(GameState* state) {
+    World* world = &state->world;
+    int center_x, center_y, local_x, local_y;
+    world_to_chunk_coords(world, state->player.x, state->player.y,
+                          &center_x, &center_y, &local_x, &local_y);
+    
+    if (world->dormant_ready && world->dormant_center_x == center_x &&
+        world->dormant_center_y == center_y) {
+        return;
     }
+    world->dormant_center_x = center_x;
+    world->dormant_center_y = center_y;
+    world->dormant_ready = 1;
     
-    // Clean up existing state
-    destroy_game_state(state);
-    state = create_game_state();
-    
-    // Read sections
-    while (fgets(buffer, sizeof(buffer), file)) {
-        buffer[strcspn(buffer, "\n")] = 0; // Remove newline
+    for (int i = 0; i < world->chunk_count; i++) {
+        WorldChunk* chunk = world->chunks[i];
+        if (!chunk->tiles) continue;
         
-        if (strcmp(buffer, "PLAYER") == 0) {
-            // Read player data
-            if (fscanf(file, "%d %d %d %d %d %d %s\n",
-                      &state->player.x, &state->player.y,
-                      &state->player.health, &state->player.max_health,
-                      &state->player.strength, &state->player.level,
-                      state->player.name) != 7) {
-                printf("Error reading player data\n");
-                fclose(file);
-                return 0;
-            }
-        }        else if (strcmp(buffer, "WORLD") == 0) {
-            // Read world data
-            if (fscanf(file, "%s %d %d %d %d %lld\n",
-                      state->world.name, &state->world.chunk_count,
-                      &state->world.chunk_width, &state->world.chunk_height,
-                      &state->world.seed, &state->world.world_time) != 6) {
-                printf("Error reading world data\n");
-                fclose(file);
-                return 0;
-            }
-            
-            // Allocate chunk array
-            state->world.chunks = (WorldChunk**)malloc(state->world.chunk_count * sizeof(WorldChunk*));
-        }
-        else if (strcmp(buffer, "CHUNKS") == 0) {
-            // Read chunk data
-            for (int i = 0; i < state->world.chunk_count; i++) {
-                // Read chunk header
-                int chunk_x, chunk_y, width, height, active;
-                time_t last_updated;
-                  if (fscanf(file, "CHUNK %d %d %d %d %d %lld\n",
-                          &chunk_x, &chunk_y, &width, &height,
-                          &active, &last_updated) != 6) {
-                    printf("Error reading chunk header\n");
-                    fclose(file);
-                    return 0;
-                }
-                
-                // Create chunk
-                state->world.chunks[i] = (WorldChunk*)malloc(sizeof(WorldChunk));
-                WorldChunk* chunk = state->world.chunks[i];
-                chunk->x = chunk_x;
-                chunk->y = chunk_y;
-                chunk->width = width;
-                chunk->height = height;
-                chunk->active = active;
-                chunk->last_updated = last_updated;
-                
-                // Allocate tiles
-                chunk->tiles = (WorldTile**)malloc(height * sizeof(WorldTile*));
-                for (int y = 0; y < height; y++) {
-                    chunk->tiles[y] = (WorldTile*)malloc(width * sizeof(WorldTile));
-                    
-                    // Read tile data for this row
-                    for (int x = 0; x < width; x++) {
-                        WorldTile* tile = &chunk->tiles[y][x];
-                        int type, walkable, transparent, entity_id, item_id;
-                        char display_char;
-                        
-                        if (fscanf(file, "%d %c %d %d %d %d\n",
-                                  &type, &display_char,
-                                  &walkable, &transparent,
-                                  &entity_id, &item_id) != 6) {
-                            printf("Error reading tile data\n");
-                            fclose(file);
-                            return 0;
-                        }
-                        
-                        tile->type = (TileType)type;
-                        tile->display_char = display_char;
-                        tile->walkable = walkable;
-                        tile->transparent = transparent;
-                        tile->entity_id = entity_id;
-                        tile->item_id = item_id;
-                    }
-                }
-            }
-        }
-        else if (strncmp(buffer, "ENEMIES", 7) == 0) {
-            // Read enemy count
-            if (sscanf(buffer, "ENEMIES %d", &state->enemy_count) != 1) {
-                printf("Error reading enemy count\n");
-                fclose(file);
-                return 0;
-            }
-            
-            // Allocate enemies array
-            state->enemies = (AIEnemy*)malloc(state->enemy_count * sizeof(AIEnemy));
-            
-            // Read each enemy
-            for (int i = 0; i < state->enemy_count; i++) {
-                AIEnemy* enemy = &state->enemies[i];
-                
-                if (fscanf(file, "%d %d %d %d %d %d %d %d\n",
-                          &enemy->id, &enemy->base.x, &enemy->base.y,
-                          &enemy->base.health, &enemy->faction_id,
-                          &enemy->ai_state, &enemy->detection_radius,
-                          &enemy->behavior_flags) != 8) {
-                    printf("Error reading enemy data\n");
-                    fclose(file);
-                    return 0;
-                }
-                
-                // Set icon and name based on faction/type
-                enemy->base.icon = 'G'; // Default goblin for now
-                enemy->base.name = "Goblin"; // Default
-            }
-        }
-        else if (strncmp(buffer, "ITEMS", 5) == 0) {
-            // Read item count
-            if (sscanf(buffer, "ITEMS %d", &state->item_count) != 1) {
-                printf("Error reading item count\n");
-                fclose(file);
-                return 0;
-            }
-            
-            // Allocate items array
-            state->items = (GameItem*)malloc(state->item_count * sizeof(GameItem));
-            
-            // Read each item
-            for (int i = 0; i < state->item_count; i++) {
-                GameItem* item = &state->items[i];
-                  if (fscanf(file, "%s %c %d %lf %d\n",
-                          item->name, &item->icon,
-                          &item->value, &item->weight, &item->type) != 5) {
-                    printf("Error reading item data\n");
-                    fclose(file);
-                    return 0;
-                }
-            }
-        }
-        else if (strcmp(buffer, "END") == 0) {
-            break;
-        }
+        if (chunk_sim_tier(state, chunk->x, chunk->y) == SIM_FROZEN) make_chunk_dormant(world, chunk);
     }
-    
-    fclose(file);
-    state->is_loaded = 1;
-    strcpy(state->save_file, filename);
-    printf("Game loaded from %s\n", filename);
-    return 1;
 }
 
+// Game state management
+
 /**
  * Update game state (called once per turn)
  */
@@ -411,17 +296,13 @@ void update_game_state(GameState* state) {
     state->world.world_time++;
     state->world.turn_counter++;
     
-    // Update active chunks
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        if (state->world.chunks[i]->active) {
-            simulate_world_chunk(state, state->world.chunks[i]);
-        }
-    }
+    // Chunks near the player and the enemies in them, by simulation tier
+    simulate_turn(state);
     
-    // Process AI for all enemies
-    for (int i = 0; i < state->enemy_count; i++) {
-        process_enemy_ai(state, &state->enemies[i]);
-    }
+    // Chunks the player has left frozen go back to their packed form
+    double phase_start = platform_time_ms();
+    pack_dormant_chunks(state);
+    end_sim_phase(state, PHASE_WORLD, &phase_start);
     
     // Update faction relations periodically
     if (state->world.turn_counter % 10 == 0) {
@@ -435,243 +316,92 @@ void update_game_state(GameState* state) {
 void destroy_game_state(GameState* state) {
     if (!state) return;
     
+    // The save worker may still be reading the mapping
+    wait_for_save(state);
+    
     // Free chunks and tiles
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        WorldChunk* chunk = state->world.chunks[i];
-        
-        for (int y = 0; y < chunk->height; y++) {
-            free(chunk->tiles[y]);
-        }
-        
-        free(chunk->tiles);
-        free(chunk);
+    for (int i = 0; state->world.chunks && i < state->world.chunk_count; i++) {
+        destroy_chunk(state->world.chunks[i]);
     }
     
     free(state->world.chunks);
+    free(state->world.chunk_slots);
+    free_save_mapping(state->world.mapping);
     
     // Free enemies
-    if (state->enemies) {
-        free(state->enemies);
-    }
+    enemy_store_clear(&state->enemies);
     
     // Free items
-    if (state->items) {
-        free(state->items);
-    }
+    item_store_clear(&state->items);
+    
+    // Stop the simulation threads
+    free_sim_threads(state);
     
     // Reset state to default values
     memset(state, 0, sizeof(GameState));
 }
 
-/**
- * Convert the world representation to the engine representation
- */
-void world_to_engine(GameState* state) {
-    if (!state) return;
-    
-    // Get active chunk
-    WorldChunk* chunk = get_chunk_at(state, 
-                                     state->world.current_chunk_x, 
-                                     state->world.current_chunk_y);
-    if (!chunk) return;
-    
-    // Copy tile data to engine world representation
-    for (int y = 0; y < chunk->height && y < HEIGHT; y++) {
-        for (int x = 0; x < chunk->width && x < WIDTH; x++) {
-            WorldTile* tile = &chunk->tiles[y][x];
-            
-            // Set display character based on tile type
-            world[y][x] = tile->display_char;
-            
-            // Set collision map
-            collisionMap[y][x] = tile->walkable ? 0 : 1;
-            
-            // Add entities if present
-            if (tile->entity_id > 0) {
-                AIEnemy* enemy = get_enemy(state, tile->entity_id);
-                if (enemy) {
-                    world[y][x] = enemy->base.icon;
-                }
-            }
-            
-            // Player position is special (handled separately)
-            if (state->player.x == x && state->player.y == y) {
-                world[y][x] = '@';
-            }
-        }
-    }
-    
-    // Update enemy list for engine
-    enemyCount = 0;
-    for (int i = 0; i < state->enemy_count; i++) {
-        AIEnemy* ai_enemy = &state->enemies[i];
-        
-        // Only add enemies in current chunk
-        if (ai_enemy->base.x >= 0 && ai_enemy->base.x < WIDTH &&
-            ai_enemy->base.y >= 0 && ai_enemy->base.y < HEIGHT) {
-            
-            // Create engine enemy
-            enemy* new_enemy = (enemy*)malloc(sizeof(enemy));
-            new_enemy->x = ai_enemy->base.x;
-            new_enemy->y = ai_enemy->base.y;
-            new_enemy->icon = ai_enemy->base.icon;
-            new_enemy->health = ai_enemy->base.health;
-            new_enemy->name = ai_enemy->base.name;
-            
-            // Add to engine list
-            enemyList[enemyCount++] = new_enemy;
-        }
-    }
-}
-
-/**
- * Convert the engine representation to the world representation
- */
-void engine_to_world(GameState* state) {
-    if (!state) return;
-    
-    // Get or create active chunk
-    WorldChunk* chunk = get_chunk_at(state, 
-                                     state->world.current_chunk_x, 
-                                     state->world.current_chunk_y);
-    if (!chunk) {
-        load_chunk(state, state->world.current_chunk_x, state->world.current_chunk_y);
-        chunk = get_chunk_at(state, state->world.current_chunk_x, state->world.current_chunk_y);
-    }
-    
-    // Copy engine world to game state
-    for (int y = 0; y < HEIGHT && y < chunk->height; y++) {
-        for (int x = 0; x < WIDTH && x < chunk->width; x++) {
-            WorldTile* tile = &chunk->tiles[y][x];
-            
-            // Set tile type based on character
-            switch (world[y][x]) {
-                case 'w':
-                    tile->type = TILE_WALL;
-                    tile->display_char = 'w';
-                    tile->walkable = 0;
-                    tile->transparent = 0;
-                    break;
-                    
-                case '.':
-                    tile->type = TILE_FLOOR;
-                    tile->display_char = '.';
-                    tile->walkable = 1;
-                    tile->transparent = 1;
-                    break;
-                    
-                case '@':
-                    // Player position - floor tile underneath
-                    tile->type = TILE_FLOOR;
-                    tile->display_char = '.';
-                    tile->walkable = 1;
-                    tile->transparent = 1;
-                    
-                    // Update player position
-                    state->player.x = x;
-                    state->player.y = y;
-                    break;
-                    
-                default:
-                    // Check if it's an enemy
-                    for (int i = 0; i < enemyCount; i++) {
-                        if (enemyList[i]->x == x && enemyList[i]->y == y) {
-                            // It's an enemy - save entity ID
-                            tile->type = TILE_FLOOR; // Floor under enemy
-                            tile->display_char = '.';
-                            tile->walkable = 1;
-                            tile->transparent = 1;
-                            
-                            // Create AI enemy if needed
-                            if (state->enemy_count == 0) {
-                                state->enemies = (AIEnemy*)malloc(sizeof(AIEnemy));
-                            } else {
-                                state->enemies = (AIEnemy*)realloc(state->enemies, 
-                                                         (state->enemy_count + 1) * sizeof(AIEnemy));
-                            }
-                            
-                            // Initialize enemy
-                            AIEnemy* ai_enemy = &state->enemies[state->enemy_count];
-                            ai_enemy->id = state->enemy_count + 1; // 1-based IDs
-                            ai_enemy->base.x = x;
-                            ai_enemy->base.y = y;
-                            ai_enemy->base.health = 10;
-                            ai_enemy->base.icon = enemyList[i]->icon;
-                            ai_enemy->base.name = enemyList[i]->name;
-                            ai_enemy->faction_id = 1; // Default faction
-                            ai_enemy->ai_state = 0; // Idle
-                            ai_enemy->detection_radius = 5;
-                            ai_enemy->memory_count = 0;
-                            ai_enemy->behavior_flags = 0;
-                            
-                            // Link enemy to tile
-                            tile->entity_id = ai_enemy->id;
-                            
-                            state->enemy_count++;
-                            break;
-                        }
-                    }
-                    break;
-            }
-        }
-    }
-}
-
 // World interaction
 
 /**
- * Set a tile type at a specific position
+ * Set a tile's type along with its display character and flags
  */
-void set_tile(GameState* state, int x, int y, TileType type) {
-    if (!state) return;
-    
-    WorldTile* tile = get_tile(state, x, y);
+void init_tile(WorldTile* tile, TileType type) {
     if (!tile) return;
     
-    tile->type = type;
+    tile->type = (unsigned char)type;
     
     // Update display character and properties based on type
     switch (type) {
         case TILE_EMPTY:
             tile->display_char = ' ';
-            tile->walkable = 0;
-            tile->transparent = 1;
+            tile_set_flags(tile, 0, 1);
             break;
             
         case TILE_FLOOR:
             tile->display_char = '.';
-            tile->walkable = 1;
-            tile->transparent = 1;
+            tile_set_flags(tile, 1, 1);
             break;
             
         case TILE_WALL:
             tile->display_char = 'w';
-            tile->walkable = 0;
-            tile->transparent = 0;
+            tile_set_flags(tile, 0, 0);
             break;
             
         case TILE_DOOR:
             tile->display_char = '+';
-            tile->walkable = 1;
-            tile->transparent = 0;
+            tile_set_flags(tile, 1, 0);
             break;
             
         case TILE_WATER:
             tile->display_char = '~';
-            tile->walkable = 0;
-            tile->transparent = 1;
+            tile_set_flags(tile, 0, 1);
             break;
             
         case TILE_LAVA:
             tile->display_char = '^';
-            tile->walkable = 0;
-            tile->transparent = 1;
+            tile_set_flags(tile, 0, 1);
             break;
     }
 }
 
 /**
- * Get a tile at a specific position
+ * Set a tile type at a specific position in the current chunk
+ */
+void set_tile(GameState* state, int x, int y, TileType type) {
+    if (!state) return;
+    
+    WorldChunk* chunk = get_chunk_at(state, 
+                                     state->world.current_chunk_x, 
+                                     state->world.current_chunk_y);
+    if (!chunk || x < 0 || y < 0 || x >= chunk->width || y >= chunk->height)
+        return;
+    
+    set_tile_world(state, chunk->x * chunk->width + x, chunk->y * chunk->height + y, type);
+}
+
+/**
+ * Get a tile at a specific position in the current chunk
  */
 WorldTile* get_tile(GameState* state, int x, int y) {
     if (!state) return NULL;
@@ -687,17 +417,233 @@ WorldTile* get_tile(GameState* state, int x, int y) {
     if (x < 0 || y < 0 || x >= chunk->width || y >= chunk->height)
         return NULL;
     
-    return &chunk->tiles[y][x];
+    return CHUNK_TILE(chunk, x, y);
 }
 
 /**
- * Check if a position is walkable
+ * Check if a position in the current chunk is walkable
  */
 int is_walkable(GameState* state, int x, int y) {
-    WorldTile* tile = get_tile(state, x, y);
+    if (!state) return 0;
+    
+    WorldChunk* chunk = get_chunk_at(state, state->world.current_chunk_x, state->world.current_chunk_y);
+    if (!chunk || x < 0 || y < 0 || x >= chunk->width || y >= chunk->height) return 0;
+    
+    return is_walkable_world(state, chunk->x * chunk->width + x, chunk->y * chunk->height + y);
+}
+
+/**
+ * Hash chunk coordinates into the chunk index
+ */
+static unsigned int chunk_hash(int chunk_x, int chunk_y) {
+    unsigned int h = (unsigned int)chunk_x * 0x9E3779B1u ^ (unsigned int)chunk_y * 0x85EBCA77u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+/**
+ * Insert chunk array index into the hash index, growing it when half full
+ */
+static void chunk_index_insert(World* world, int index) {
+    if ((world->chunk_count + 1) * 2 > world->chunk_slot_capacity) {
+        rebuild_chunk_index(world);
+        return;
+    }
+    
+    WorldChunk* chunk = world->chunks[index];
+    unsigned int mask = (unsigned int)world->chunk_slot_capacity - 1;
+    unsigned int slot = chunk_hash(chunk->x, chunk->y) & mask;
+    
+    while (world->chunk_slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    
+    world->chunk_slots[slot] = index + 1;
+}
+
+/**
+ * Rebuild the chunk hash index from the chunk array
+ */
+void rebuild_chunk_index(World* world) {
+    if (!world) return;
+    
+    // Keep the load factor at or below one half
+    int capacity = 16;
+    while (capacity < (world->chunk_count + 1) * 2) {
+        capacity *= 2;
+    }
+    
+    free(world->chunk_slots);
+    world->chunk_slots = (int*)calloc(capacity, sizeof(int));
+    world->chunk_slot_capacity = world->chunk_slots ? capacity : 0;
+    world->last_chunk = NULL;
+    if (!world->chunk_slots) return;
+    
+    unsigned int mask = (unsigned int)capacity - 1;
+    for (int i = 0; i < world->chunk_count; i++) {
+        WorldChunk* chunk = world->chunks[i];
+        unsigned int slot = chunk_hash(chunk->x, chunk->y) & mask;
+        
+        while (world->chunk_slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        
+        world->chunk_slots[slot] = i + 1;
+    }
+}
+
+/**
+ * Get the chunk containing a world position, along with the local position inside it
+ */
+WorldChunk* get_chunk_for_world(GameState* state, int x, int y, int* local_x, int* local_y) {
+    if (!state || state->world.chunk_width <= 0 || state->world.chunk_height <= 0) return NULL;
+    
+    int chunk_x, chunk_y;
+    world_to_chunk_coords(&state->world, x, y, &chunk_x, &chunk_y, local_x, local_y);
+    
+    return get_chunk_at(state, chunk_x, chunk_y);
+}
+
+/**
+ * Get a tile at a world position (NULL if its chunk isn't loaded)
+ */
+WorldTile* get_tile_world(GameState* state, int x, int y) {
+    int local_x, local_y;
+    WorldChunk* chunk = get_chunk_for_world(state, x, y, &local_x, &local_y);
+    if (!chunk) return NULL;
+    
+    return CHUNK_TILE(chunk, local_x, local_y);
+}
+
+/**
+ * Set a tile type at a world position
+ */
+void set_tile_world(GameState* state, int x, int y, TileType type) {
+    int local_x, local_y;
+    WorldChunk* chunk = get_chunk_for_world(state, x, y, &local_x, &local_y);
+    if (!chunk) return;
+    
+    WorldTile* tile = CHUNK_TILE(chunk, local_x, local_y);
+    int was_walkable = tile_walkable(tile);
+    int was_transparent = tile_transparent(tile);
+    init_tile(tile, type);
+    chunk->dirty = 1;
+    
+    // Invalidate cached flow fields when walkability changes
+    if (tile_walkable(tile) != was_walkable) {
+        chunk->walk_version++;
+    }
+    
+    // And the field of view when sight lines change
+    if (tile_transparent(tile) != was_transparent) {
+        state->world.terrain_version++;
+    }
+    update_tile_planes(chunk, local_x, local_y);
+}
+
+/**
+ * Get a tile at a world position for modification, marking its chunk dirty
+ */
+static WorldTile* edit_tile_world(GameState* state, int x, int y) {
+    int local_x, local_y;
+    WorldChunk* chunk = get_chunk_for_world(state, x, y, &local_x, &local_y);
+    if (!chunk) return NULL;
+    
+    chunk->dirty = 1;
+    return CHUNK_TILE(chunk, local_x, local_y);
+}
+
+/**
+ * Put an entity id on a world tile (0 clears it), keeping the occupied plane current
+ */
+static void set_tile_entity(GameState* state, int x, int y, int entity_id) {
+    int local_x, local_y;
+    WorldChunk* chunk = get_chunk_for_world(state, x, y, &local_x, &local_y);
+    if (!chunk) return;
+    
+    chunk->dirty = 1;
+    CHUNK_TILE(chunk, local_x, local_y)->entity_id = (unsigned short)entity_id;
+    
+    // Only occupancy changed; stale planes pick it up when rebuilt
+    TilePlanes* planes = chunk->planes;
+    if (planes && planes->valid) plane_set(planes, PLANE_OCCUPIED, local_x, local_y, entity_id != 0);
+}
+
+/**
+ * Check if a world position is walkable and free
+ */
+int is_walkable_world(GameState* state, int x, int y) {
+    WorldTile* tile = get_tile_world(state, x, y);
     if (!tile) return 0;
     
-    return tile->walkable && tile->entity_id == 0;
+    return tile_walkable(tile) && tile->entity_id == 0;
+}
+
+/**
+ * Collect the 3x3 block of chunks around a chunk
+ */
+void get_chunk_window(GameState* state, int center_chunk_x, int center_chunk_y, ChunkWindow* window) {
+    if (!state || !window) return;
+    
+    window->chunk_width = state->world.chunk_width;
+    window->chunk_height = state->world.chunk_height;
+    window->width = window->chunk_width * 3;
+    window->height = window->chunk_height * 3;
+    window->origin_x = (center_chunk_x - 1) * window->chunk_width;
+    window->origin_y = (center_chunk_y - 1) * window->chunk_height;
+    
+    for (int dy = 0; dy < 3; dy++) {
+        for (int dx = 0; dx < 3; dx++) {
+            WorldChunk* chunk = get_chunk_at(state, center_chunk_x + dx - 1, center_chunk_y + dy - 1);
+            window->chunks[dy * 3 + dx] = chunk;
+            window->planes[dy * 3 + dx] = chunk ? chunk_planes(chunk) : NULL;
+        }
+    }
+}
+
+/**
+ * Get a tile at a world position without decoding chunks or touching the lookup cache
+ * NULL if its chunk isn't loaded or not decoded yet; safe from worker threads.
+ */
+const WorldTile* peek_tile_world(GameState* state, int x, int y) {
+    if (!state || state->world.chunk_width <= 0 || state->world.chunk_height <= 0) return NULL;
+    
+    int chunk_x, chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, x, y, &chunk_x, &chunk_y, &local_x, &local_y);
+    int index = get_chunk_index(state, chunk_x, chunk_y);
+    if (index < 0) return NULL;
+    
+    const WorldChunk* chunk = state->world.chunks[index];
+    return chunk->tiles ? CHUNK_TILE(chunk, local_x, local_y) : NULL;
+}
+
+/**
+ * Collect the 3x3 block of chunks around a chunk without decoding or building anything
+ * Chunks not decoded yet, or without built planes, are left out (NULL), so
+ * this is safe from worker threads; get_chunk_window beforehand fills them in.
+ */
+void peek_chunk_window(GameState* state, int center_chunk_x, int center_chunk_y, ChunkWindow* window) {
+    if (!state || !window) return;
+    
+    window->chunk_width = state->world.chunk_width;
+    window->chunk_height = state->world.chunk_height;
+    window->width = window->chunk_width * 3;
+    window->height = window->chunk_height * 3;
+    window->origin_x = (center_chunk_x - 1) * window->chunk_width;
+    window->origin_y = (center_chunk_y - 1) * window->chunk_height;
+    
+    for (int dy = 0; dy < 3; dy++) {
+        for (int dx = 0; dx < 3; dx++) {
+            int index = get_chunk_index(state, center_chunk_x + dx - 1, center_chunk_y + dy - 1);
+            WorldChunk* chunk = index >= 0 ? state->world.chunks[index] : NULL;
+            if (chunk && (!chunk->tiles || !chunk->planes || !chunk->planes->valid)) chunk = NULL;
+            
+            window->chunks[dy * 3 + dx] = chunk;
+            window->planes[dy * 3 + dx] = chunk ? chunk->planes : NULL;
+        }
+    }
 }
 
 /**
@@ -706,27 +652,42 @@ int is_walkable(GameState* state, int x, int y) {
 WorldChunk* get_chunk_at(GameState* state, int chunk_x, int chunk_y) {
     if (!state) return NULL;
     
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        if (state->world.chunks[i]->x == chunk_x && 
-            state->world.chunks[i]->y == chunk_y) {
-            return state->world.chunks[i];
-        }
+    // Most lookups hit the same chunk as the previous one
+    WorldChunk* last = state->world.last_chunk;
+    if (last && last->x == chunk_x && last->y == chunk_y && last->tiles) {
+        return last;
     }
     
-    return NULL;
+    int index = get_chunk_index(state, chunk_x, chunk_y);
+    if (index < 0) return NULL;
+    
+    // First touch of a dormant or lazily loaded chunk decodes it
+    WorldChunk* chunk = state->world.chunks[index];
+    if (!chunk->tiles && !materialize_chunk(&state->world, chunk)) return NULL;
+    
+    state->world.last_chunk = chunk;
+    return chunk;
 }
 
 /**
  * Get index of a chunk
  */
 int get_chunk_index(GameState* state, int chunk_x, int chunk_y) {
-    if (!state) return -1;
+    if (!state || state->world.chunk_slot_capacity == 0) return -1;
     
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        if (state->world.chunks[i]->x == chunk_x && 
-            state->world.chunks[i]->y == chunk_y) {
-            return i;
+    unsigned int mask = (unsigned int)state->world.chunk_slot_capacity - 1;
+    unsigned int slot = chunk_hash(chunk_x, chunk_y) & mask;
+    
+    // Linear probing until an empty slot
+    while (state->world.chunk_slots[slot] != 0) {
+        int index = state->world.chunk_slots[slot] - 1;
+        WorldChunk* chunk = state->world.chunks[index];
+        
+        if (chunk->x == chunk_x && chunk->y == chunk_y) {
+            return index;
         }
+        
+        slot = (slot + 1) & mask;
     }
     
     return -1;
@@ -735,50 +696,45 @@ int get_chunk_index(GameState* state, int chunk_x, int chunk_y) {
 // Entity management
 
 /**
- * Move an entity to a new position
+ * Move an entity to a new world position
  */
 void move_entity(GameState* state, int entity_id, int new_x, int new_y) {
     if (!state || entity_id <= 0) return;
     
     // Handle player
     if (entity_id == 0) {
-        // Clear old tile
-        WorldTile* old_tile = get_tile(state, state->player.x, state->player.y);
-        if (old_tile) old_tile->entity_id = 0;
-        
-        // Update position
+        // The player isn't linked from tiles
         state->player.x = new_x;
         state->player.y = new_y;
-        
-        // Update new tile
-        WorldTile* new_tile = get_tile(state, new_x, new_y);
-        if (new_tile) new_tile->entity_id = 0; // Player is special
-        
         return;
     }
     
     // Find entity
-    AIEnemy* enemy = NULL;
-    for (int i = 0; i < state->enemy_count; i++) {
-        if (state->enemies[i].id == entity_id) {
-            enemy = &state->enemies[i];
-            break;
-        }
-    }
+    int index = enemy_store_find(&state->enemies, entity_id);
+    if (index < 0) return;
     
-    if (!enemy) return;
+    move_enemy(state, index, new_x, new_y);
+}
+
+/**
+ * Move the enemy at a store index, keeping tile links in step
+ * Returns 0 if the enemy could not be moved
+ */
+static int move_enemy(GameState* state, int index, int new_x, int new_y) {
+    EnemyStore* enemies = &state->enemies;
+    int old_x = enemies->x[index];
+    int old_y = enemies->y[index];
     
-    // Clear old position
-    WorldTile* old_tile = get_tile(state, enemy->base.x, enemy->base.y);
-    if (old_tile) old_tile->entity_id = 0;
+    // Update position; if the index can't take it the enemy stays put
+    if (!enemy_store_move(enemies, index, new_x, new_y)) return 0;
+    state->enemies_dirty = 1;
     
-    // Update position
-    enemy->base.x = new_x;
-    enemy->base.y = new_y;
+    // Clear old position
+    set_tile_entity(state, old_x, old_y, 0);
     
     // Update new tile
-    WorldTile* new_tile = get_tile(state, new_x, new_y);
-    if (new_tile) new_tile->entity_id = entity_id;
+    set_tile_entity(state, new_x, new_y, handle_tile_id(enemies->id[index]));
+    return 1;
 }
 
 /**
@@ -787,26 +743,18 @@ void move_entity(GameState* state, int entity_id, int new_x, int new_y) {
 int add_enemy(GameState* state, AIEnemy enemy) {
     if (!state) return 0;
     
-    // Resize enemy array
-    if (state->enemy_count == 0) {
-        state->enemies = (AIEnemy*)malloc(sizeof(AIEnemy));
-    } else {
-        state->enemies = (AIEnemy*)realloc(state->enemies, 
-                                  (state->enemy_count + 1) * sizeof(AIEnemy));
-    }
-    
-    // Set ID
-    enemy.id = state->enemy_count + 1;
-    
-    // Add enemy
-    state->enemies[state->enemy_count] = enemy;
-    state->enemy_count++;
+    // Always a fresh ID, in step with the clock
+    enemy.id = 0;
+    enemy.last_action_time = state->world.turn_counter;
+    int index = enemy_store_add(&state->enemies, &enemy);
+    if (index < 0) return 0;
+    state->enemies_dirty = 1;
     
     // Update tile
-    WorldTile* tile = get_tile(state, enemy.base.x, enemy.base.y);
-    if (tile) tile->entity_id = enemy.id;
+    int id = state->enemies.id[index];
+    set_tile_entity(state, enemy.base.x, enemy.base.y, handle_tile_id(id));
     
-    return enemy.id;
+    return id;
 }
 
 /**
@@ -815,245 +763,556 @@ int add_enemy(GameState* state, AIEnemy enemy) {
 void remove_enemy(GameState* state, int enemy_id) {
     if (!state || enemy_id <= 0) return;
     
-    int index = -1;
-    for (int i = 0; i < state->enemy_count; i++) {
-        if (state->enemies[i].id == enemy_id) {
-            index = i;
-            break;
-        }
-    }
-    
+    int index = enemy_store_find(&state->enemies, enemy_id);
     if (index == -1) return;
     
     // Clear tile
-    WorldTile* tile = get_tile(state, state->enemies[index].base.x, 
-                               state->enemies[index].base.y);
-    if (tile) tile->entity_id = 0;
+    set_tile_entity(state, state->enemies.x[index], state->enemies.y[index], 0);
     
-    // Remove enemy by shifting array
-    for (int i = index; i < state->enemy_count - 1; i++) {
-        state->enemies[i] = state->enemies[i + 1];
-    }
+    enemy_store_remove(&state->enemies, index);
+    state->enemies_dirty = 1;
+}
+
+/**
+ * Get an enemy's store index by handle or tile id (-1 if none)
+ */
+int get_enemy(GameState* state, int enemy_id) {
+    if (!state) return -1;
     
-    state->enemy_count--;
+    return enemy_store_find(&state->enemies, enemy_id);
+}
+
+/**
+ * Get the store index of the enemy at a world position (-1 if none)
+ */
+int get_enemy_at(GameState* state, int x, int y) {
+    if (!state) return -1;
     
-    // Resize array if needed
-    if (state->enemy_count > 0) {
-        state->enemies = (AIEnemy*)realloc(state->enemies, 
-                                  state->enemy_count * sizeof(AIEnemy));
-    } else {
-        free(state->enemies);
-        state->enemies = NULL;
-    }
+    WorldTile* tile = get_tile_world(state, x, y);
+    if (!tile || tile->entity_id <= 0) return -1;
+    
+    return get_enemy(state, tile->entity_id);
 }
 
 /**
- * Get an enemy by ID
+ * Store indices of the enemies within radius of a position
+ * Returns the number found; only the first max_out are stored
  */
-AIEnemy* get_enemy(GameState* state, int enemy_id) {
-    if (!state || enemy_id <= 0) return NULL;
+int get_enemies_in_radius(GameState* state, int x, int y, int radius, int* out, int max_out) {
+    if (!state) return 0;
     
-    for (int i = 0; i < state->enemy_count; i++) {
-        if (state->enemies[i].id == enemy_id) {
-            return &state->enemies[i];
-        }
+    int found = spatial_query_radius(&state->enemies.grid, x, y, radius, out, max_out);
+    for (int i = 0; i < found && i < max_out; i++) {
+        out[i] = state->enemies.handles.slots[out[i]].value;
     }
+    return found;
+}
+
+/**
+ * Store indices of the enemies inside a rectangle (inclusive)
+ * Returns the number found; only the first max_out are stored
+ */
+int get_enemies_in_rect(GameState* state, int min_x, int min_y, int max_x, int max_y,
+                        int* out, int max_out) {
+    if (!state) return 0;
     
-    return NULL;
+    int found = spatial_query_rect(&state->enemies.grid, min_x, min_y, max_x, max_y, out, max_out);
+    for (int i = 0; i < found && i < max_out; i++) {
+        out[i] = state->enemies.handles.slots[out[i]].value;
+    }
+    return found;
 }
 
+// Item management
+
 /**
- * Get an enemy at specific coordinates
+ * Put an item on top of a tile's stack and at the head of its chunk's list
  */
-AIEnemy* get_enemy_at(GameState* state, int x, int y) {
-    if (!state) return NULL;
+static int place_item(GameState* state, int slot, int x, int y) {
+    WorldTile* tile = edit_tile_world(state, x, y);
+    if (!tile) return 0;
     
-    WorldTile* tile = get_tile(state, x, y);
-    if (!tile || tile->entity_id <= 0) return NULL;
+    int chunk_x, chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, x, y, &chunk_x, &chunk_y, &local_x, &local_y);
+    WorldChunk* chunk = get_chunk_at(state, chunk_x, chunk_y);
     
-    return get_enemy(state, tile->entity_id);
+    ItemEntry* entries = state->items.entries;
+    unsigned short id = (unsigned short)(slot + 1);
+    entries[slot].x = x;
+    entries[slot].y = y;
+    entries[slot].below = tile->item_id;
+    tile->item_id = id;
+    
+    entries[slot].chunk_prev = 0;
+    entries[slot].chunk_next = chunk->item_head;
+    if (chunk->item_head) entries[chunk->item_head - 1].chunk_prev = id;
+    chunk->item_head = id;
+    
+    return 1;
 }
 
-// Item management
+/**
+ * Take an item off its tile's stack and out of its chunk's list
+ */
+static void unplace_item(GameState* state, int slot) {
+    ItemEntry* entries = state->items.entries;
+    ItemEntry* entry = &entries[slot];
+    if (entry->x == ITEM_NOWHERE || entry->x == ITEM_UNKNOWN) return;
+    
+    unsigned short id = (unsigned short)(slot + 1);
+    
+    WorldTile* tile = edit_tile_world(state, entry->x, entry->y);
+    if (tile) {
+        if (tile->item_id == id) {
+            tile->item_id = entry->below;
+        } else {
+            // Somewhere lower in the stack
+            for (unsigned short above = tile->item_id; above; above = entries[above - 1].below) {
+                if (entries[above - 1].below == id) {
+                    entries[above - 1].below = entry->below;
+                    break;
+                }
+            }
+        }
+    }
+    
+    int chunk_x, chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, entry->x, entry->y, &chunk_x, &chunk_y, &local_x, &local_y);
+    int index = get_chunk_index(state, chunk_x, chunk_y);
+    WorldChunk* chunk = index >= 0 ? state->world.chunks[index] : NULL;
+    
+    if (entry->chunk_prev) entries[entry->chunk_prev - 1].chunk_next = entry->chunk_next;
+    else if (chunk && chunk->item_head == id) chunk->item_head = entry->chunk_next;
+    if (entry->chunk_next) entries[entry->chunk_next - 1].chunk_prev = entry->chunk_prev;
+    
+    entry->x = ITEM_NOWHERE;
+    entry->y = ITEM_NOWHERE;
+    entry->below = 0;
+    entry->chunk_prev = 0;
+    entry->chunk_next = 0;
+}
 
 /**
- * Add a new item to the game
+ * Add a new item to the game, placed at a world position (x < 0 for none)
+ * Items placed on an occupied tile stack on top of what is there.
  */
 int add_item(GameState* state, GameItem new_item, int x, int y) {
     if (!state) return 0;
     
-    // Resize item array
-    if (state->item_count == 0) {
-        state->items = (GameItem*)malloc(sizeof(GameItem));
-    } else {
-        state->items = (GameItem*)realloc(state->items, 
-                               (state->item_count + 1) * sizeof(GameItem));
-    }
-    
-    // Add item
-    state->items[state->item_count] = new_item;
-    int item_id = state->item_count + 1;
-    state->item_count++;
+    int slot = item_store_add(&state->items, &new_item, 0);
+    if (slot < 0) return 0;
+    state->items_dirty = 1;
     
     // Update tile if position is valid
     if (x >= 0 && y >= 0) {
-        WorldTile* tile = get_tile(state, x, y);
-        if (tile) tile->item_id = item_id;
+        place_item(state, slot, x, y);
     }
     
-    return item_id;
+    return item_store_handle(&state->items, slot);
 }
 
 /**
- * Get an item by ID
+ * Get an item by handle or tile id
  */
 GameItem* get_item(GameState* state, int item_id) {
-    if (!state || item_id <= 0 || item_id > state->item_count) return NULL;
+    if (!state) return NULL;
     
-    return &state->items[item_id - 1];
+    int slot = slot_map_find(&state->items.handles, item_id);
+    return slot < 0 ? NULL : &state->items.entries[slot].item;
 }
 
 /**
  * Remove an item from the game
+ * Only the item's own tile and list neighbours are touched.
  */
 void remove_item(GameState* state, int item_id) {
-    if (!state || item_id <= 0 || item_id > state->item_count) return;
+    if (!state) return;
+    
+    int slot = slot_map_find(&state->items.handles, item_id);
+    if (slot < 0) return;
+    
+    unplace_item(state, slot);
+    item_store_remove(&state->items, slot);
+    state->items_dirty = 1;
+}
+
+/**
+ * Handle of the top item on a tile (0 if none)
+ */
+int get_item_at(GameState* state, int x, int y) {
+    if (!state) return 0;
+    
+    WorldTile* tile = get_tile_world(state, x, y);
+    if (!tile || tile->item_id == 0) return 0;
+    
+    int slot = slot_map_find(&state->items.handles, tile->item_id);
+    return slot < 0 ? 0 : item_store_handle(&state->items, slot);
+}
+
+/**
+ * Handle of the item under this one on the same tile (0 if none)
+ */
+int get_item_below(GameState* state, int item_id) {
+    if (!state) return 0;
+    
+    int slot = slot_map_find(&state->items.handles, item_id);
+    if (slot < 0 || state->items.entries[slot].below == 0) return 0;
+    
+    return item_store_handle(&state->items, state->items.entries[slot].below - 1);
+}
+
+/**
+ * Handle of the first item in a chunk's item list (0 if none)
+ */
+int get_chunk_item(GameState* state, WorldChunk* chunk) {
+    if (!state || !chunk || chunk->item_head == 0) return 0;
+    
+    return item_store_handle(&state->items, chunk->item_head - 1);
+}
+
+/**
+ * Handle of the next item in the same chunk (0 at the end)
+ */
+int get_next_chunk_item(GameState* state, int item_id) {
+    if (!state) return 0;
+    
+    int slot = slot_map_find(&state->items.handles, item_id);
+    if (slot < 0 || state->items.entries[slot].chunk_next == 0) return 0;
+    
+    return item_store_handle(&state->items, state->items.entries[slot].chunk_next - 1);
+}
+
+/**
+ * Rebuild every chunk's item list from item positions after a load
+ * Items from saves that didn't record positions are found on their tiles.
+ */
+void rebuild_item_links(GameState* state) {
+    if (!state) return;
+    
+    ItemStore* items = &state->items;
+    int unknown = 0;
     
-    // Clear all tile references to this item
     for (int i = 0; i < state->world.chunk_count; i++) {
-        WorldChunk* chunk = state->world.chunks[i];
-        
-        for (int y = 0; y < chunk->height; y++) {
-            for (int x = 0; x < chunk->width; x++) {
-                if (chunk->tiles[y][x].item_id == item_id) {
-                    chunk->tiles[y][x].item_id = 0;
-                }
-            }
-        }
+        state->world.chunks[i]->item_head = 0;
     }
     
-    // Remove item by shifting array
-    for (int i = item_id - 1; i < state->item_count - 1; i++) {
-        state->items[i] = state->items[i + 1];
+    for (int slot = 0; slot < items->handles.slot_count; slot++) {
+        if (items->handles.slots[slot].value == SLOT_FREE) continue;
+        if (items->entries[slot].x == ITEM_UNKNOWN) unknown = 1;
     }
     
-    state->item_count--;
-    
-    // Update references to other items (decrease ID by 1 for items after the removed one)
-    for (int i = 0; i < state->world.chunk_count; i++) {
-        WorldChunk* chunk = state->world.chunks[i];
-        
-        for (int y = 0; y < chunk->height; y++) {
-            for (int x = 0; x < chunk->width; x++) {
-                if (chunk->tiles[y][x].item_id > item_id) {
-                    chunk->tiles[y][x].item_id--;
+    // Older saves: tiles hold the only record of where each item is (one per tile)
+    if (unknown) {
+        for (int i = 0; i < state->world.chunk_count; i++) {
+            WorldChunk* chunk = state->world.chunks[i];
+            if (!chunk->tiles && !materialize_chunk(&state->world, chunk)) continue;
+            
+            for (int y = 0; y < chunk->height; y++) {
+                for (int x = 0; x < chunk->width; x++) {
+                    WorldTile* tile = CHUNK_TILE(chunk, x, y);
+                    int slot = slot_map_find(&items->handles, tile->item_id);
+                    if (slot < 0 || items->entries[slot].x != ITEM_UNKNOWN) continue;
+                    
+                    items->entries[slot].x = chunk->x * chunk->width + x;
+                    items->entries[slot].y = chunk->y * chunk->height + y;
+                    items->entries[slot].below = 0;
                 }
             }
         }
     }
     
-    // Resize array if needed
-    if (state->item_count > 0) {
-        state->items = (GameItem*)realloc(state->items, 
-                               state->item_count * sizeof(GameItem));
-    } else {
-        free(state->items);
-        state->items = NULL;
+    // Thread each placed item into its chunk's list
+    for (int slot = 0; slot < items->handles.slot_count; slot++) {
+        if (items->handles.slots[slot].value == SLOT_FREE) continue;
+        
+        ItemEntry* entry = &items->entries[slot];
+        entry->chunk_prev = 0;
+        entry->chunk_next = 0;
+        if (entry->x == ITEM_UNKNOWN) {
+            entry->x = ITEM_NOWHERE;
+            entry->y = ITEM_NOWHERE;
+        }
+        if (entry->x == ITEM_NOWHERE) continue;
+        
+        int chunk_x, chunk_y, local_x, local_y;
+        world_to_chunk_coords(&state->world, entry->x, entry->y, &chunk_x, &chunk_y, &local_x, &local_y);
+        
+        // Only the list head is needed, so a lazy chunk stays undecoded
+        int index = get_chunk_index(state, chunk_x, chunk_y);
+        WorldChunk* chunk = index >= 0 ? state->world.chunks[index] : NULL;
+        if (!chunk) {
+            entry->x = ITEM_NOWHERE;
+            entry->y = ITEM_NOWHERE;
+            continue;
+        }
+        
+        unsigned short id = (unsigned short)(slot + 1);
+        entry->chunk_next = chunk->item_head;
+        if (chunk->item_head) items->entries[chunk->item_head - 1].chunk_prev = id;
+        chunk->item_head = id;
     }
 }
 
 // AI and simulation
 
 /**
- * Process AI for a specific enemy
+ * Whether a world position is walkable and free, without decoding anything
  */
-void process_enemy_ai(GameState* state, AIEnemy* enemy) {
-    if (!state || !enemy) return;
+static int peek_walkable(GameState* state, int x, int y) {
+    const WorldTile* tile = peek_tile_world(state, x, y);
+    return tile && tile_walkable(tile) && tile->entity_id == 0;
+}
+
+/**
+ * Record a step in an intent
+ */
+static void intend_move(EnemyIntent* intent, int x, int y, int path_step) {
+    intent->flags |= INTENT_MOVE | (path_step ? INTENT_PATH_STEP : 0);
+    intent->move_x = x;
+    intent->move_y = y;
+}
+
+/**
+ * Plan a path for an enemy over its chunk window, into its own brain
+ */
+static void plan_enemy_path(GameState* state, struct PathBuffers** path_buffers, int index,
+                            EnemyBrain* brain, int target_x, int target_y) {
+    int x = state->enemies.x[index];
+    int y = state->enemies.y[index];
+    int chunk_x, chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, x, y, &chunk_x, &chunk_y, &local_x, &local_y);
+    
+    ChunkWindow window;
+    peek_chunk_window(state, chunk_x, chunk_y, &window);
+    
+    brain->path_index = 0;
+    brain->path_length = find_path_in_window(&window, path_buffers, x, y, target_x, target_y,
+                                             (PathHeuristic)state->world.path_heuristic,
+                                             brain->path, ENEMY_MAX_PATH);
+}
+
+/**
+ * Pick a chasing enemy's step toward the player: downhill on the shared
+ * flow field, or along a freshly planned path outside the field's window
+ */
+static void decide_chase_step(GameState* state, const FlowField* field, struct PathBuffers** path_buffers,
+                              int index, EnemyBrain* brain, EnemyIntent* intent) {
+    int x = state->enemies.x[index];
+    int y = state->enemies.y[index];
+    int next_x, next_y;
+    
+    if (flow_field_contains(field, x, y)) {
+        int dir = followPlayer(field->distance, field->width, field->height,
+                               x - field->window_x, y - field->window_y);
+        if (dir < 0) return;
+        
+        int dirs[4][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}}; // up, right, down, left
+        next_x = x + dirs[dir][0];
+        next_y = y + dirs[dir][1];
+    } else {
+        if (!brain) return;
+        plan_enemy_path(state, path_buffers, index, brain, state->player.x, state->player.y);
+        if (brain->path_length == 0) return;
+        
+        next_x = brain->path[0][0];
+        next_y = brain->path[0][1];
+    }
+    
+    // Adjacent to the player - hold position
+    if (next_x == state->player.x && next_y == state->player.y) return;
+    
+    if (peek_walkable(state, next_x, next_y)) {
+        intend_move(intent, next_x, next_y, 0);
+    }
+}
+
+/**
+ * Decide one turn of AI for the enemy at a store index
+ * Reads the world as it stands and writes only the intent and the enemy's
+ * own brain (its path), so enemies can decide on several threads at once.
+ * Chunks are not decoded here: get_chunk_window must have prepared the
+ * enemy's window. field is this turn's flow field toward the player and
+ * *path_buffers the calling thread's A* buffers. The turn picks the random
+ * stream, so replayed turns match live ones.
+ */
+void decide_enemy_ai(GameState* state, const FlowField* field, struct PathBuffers** path_buffers,
+                     int index, int turn, EnemyIntent* intent) {
+    EnemyStore* enemies = &state->enemies;
+    intent->index = index;
+    intent->ai_state = enemies->ai_state[index];
+    intent->flags = 0;
+    
+    // This enemy's stream for this turn
+    Rng rng;
+    rng_stream(&rng, (uint32_t)state->world.seed, RNG_DOMAIN_ENEMY, enemies->id[index], turn);
     
     // Check if player is visible
-    int can_see_player = can_detect_player(state, enemy);
+    int can_see_player = can_detect_player(state, index);
     
-    // Update AI state based on what enemy knows
-    switch (enemy->ai_state) {
+    switch (enemies->ai_state[index]) {
         case 0: // Idle
             if (can_see_player) {
                 // Player spotted! Change to chase state
-                enemy->ai_state = 2;
-                enemy->ai_target_id = 0; // Player ID
-                update_enemy_memory(state, enemy, 0, state->player.x, state->player.y);
-            } else if (rand() % 4 == 0) {
+                intent->ai_state = 2;
+                intent->flags |= INTENT_SPOTTED;
+            } else if (rng_range(&rng, 4) == 0) {
                 // Random chance to start patrolling
-                enemy->ai_state = 1;
+                intent->ai_state = 1;
             }
             break;
             
         case 1: // Patrol
             if (can_see_player) {
                 // Player spotted! Change to chase state
-                enemy->ai_state = 2;
-                enemy->ai_target_id = 0;
-                update_enemy_memory(state, enemy, 0, state->player.x, state->player.y);
+                intent->ai_state = 2;
+                intent->flags |= INTENT_SPOTTED;
             } else {
                 // Move randomly
                 int dirs[4][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}}; // up, right, down, left
-                int dir = rand() % 4;
-                int new_x = enemy->base.x + dirs[dir][0];
-                int new_y = enemy->base.y + dirs[dir][1];
+                int dir = rng_range(&rng, 4);
+                int new_x = enemies->x[index] + dirs[dir][0];
+                int new_y = enemies->y[index] + dirs[dir][1];
                 
-                if (is_walkable(state, new_x, new_y)) {
-                    move_entity(state, enemy->id, new_x, new_y);
+                if (peek_walkable(state, new_x, new_y)) {
+                    intend_move(intent, new_x, new_y, 0);
                 }
             }
             break;
             
-        case 2: // Chase player
+        case 2: { // Chase player
+            // Only peeked: brains are handed out while resolving, one thread at a time
+            EnemyBrain* brain = enemy_store_peek_brain(enemies, index);
+            
             if (can_see_player) {
-                // Update memory of player position
-                update_enemy_memory(state, enemy, 0, state->player.x, state->player.y);
-                
-                // Calculate path to player
-                calculate_path(state, enemy, state->player.x, state->player.y);
+                // Remember the player's position and step downhill on the
+                // shared flow field instead of planning our own path
+                intent->flags |= INTENT_SPOTTED;
+                if (brain) {
+                    brain->path_length = 0;
+                    brain->path_index = 0;
+                }
+                decide_chase_step(state, field, path_buffers, index, brain, intent);
+                break;
+            }
+            
+            if (!brain) {
+                // Nothing to go on - back to idle
+                intent->ai_state = 0;
+                break;
             }
             
             // Move along path if we have one
-            if (enemy->path_length > 0 && enemy->path_index < enemy->path_length) {
-                int next_x = enemy->path[enemy->path_index][0];
-                int next_y = enemy->path[enemy->path_index][1];
+            if (brain->path_length > 0 && brain->path_index < brain->path_length) {
+                int next_x = brain->path[brain->path_index][0];
+                int next_y = brain->path[brain->path_index][1];
                 
-                if (is_walkable(state, next_x, next_y)) {
-                    move_entity(state, enemy->id, next_x, next_y);
+                if (next_x == state->player.x && next_y == state->player.y) {
+                    // Adjacent to the player - hold position
+                } else if (peek_walkable(state, next_x, next_y)) {
+                    intend_move(intent, next_x, next_y, 1);
+                } else {
+                    // Blocked by another entity, replan next turn
+                    brain->path_length = 0;
+                    brain->path_index = 0;
                 }
+            } else if (brain->memory_count > 0) {
+                // No path or reached end of path - go to last known position
+                int newest_memory = 0;
+                time_t newest_time = 0;
                 
-                enemy->path_index++;
-            } else {
-                // No path or reached end of path
-                // If we can't see player, go to last known position
-                if (!can_see_player && enemy->memory_count > 0) {
-                    int newest_memory = 0;
-                    time_t newest_time = 0;
-                    
-                    // Find newest memory of player
-                    for (int i = 0; i < enemy->memory_count; i++) {
-                        if (enemy->memories[i].entity_id == 0 && 
-                            enemy->memories[i].time_seen > newest_time) {
-                            newest_memory = i;
-                            newest_time = enemy->memories[i].time_seen;
-                        }
+                // Find newest memory of player
+                for (int i = 0; i < brain->memory_count; i++) {
+                    if (brain->memories[i].entity_id == 0 && 
+                        brain->memories[i].time_seen > newest_time) {
+                        newest_memory = i;
+                        newest_time = brain->memories[i].time_seen;
                     }
-                    
-                    // Go to last known position
-                    calculate_path(state, enemy, 
-                                 enemy->memories[newest_memory].x,
-                                 enemy->memories[newest_memory].y);
-                } else if (!can_see_player) {
-                    // Lost track of player, go back to idle
-                    enemy->ai_state = 0;
                 }
+                
+                plan_enemy_path(state, path_buffers, index, brain,
+                                brain->memories[newest_memory].x,
+                                brain->memories[newest_memory].y);
+                
+                // Already there (or unreachable) - give up the chase
+                if (brain->path_length == 0) {
+                    intent->ai_state = 0;
+                    intent->flags |= INTENT_FORGET;
+                }
+            } else {
+                // Lost track of player, go back to idle
+                intent->ai_state = 0;
+                intent->flags |= INTENT_FORGET;
             }
             break;
+        }
+    }
+}
+
+/**
+ * Apply decided intents in order, one at a time
+ * Intents were decided against the world before any of them moved, so two
+ * enemies may want the same tile: the earlier intent takes it and the later
+ * enemy stays put. Ordering intents by enemy id keeps the outcome
+ * independent of where enemies sit in the store.
+ */
+void resolve_enemy_ai(GameState* state, const EnemyIntent* intents, int count) {
+    if (!state || !intents) return;
+    
+    EnemyStore* enemies = &state->enemies;
+    
+    for (int i = 0; i < count; i++) {
+        const EnemyIntent* intent = &intents[i];
+        int index = intent->index;
+        
+        enemies->ai_state[index] = intent->ai_state;
+        
+        if (intent->flags & INTENT_SPOTTED) {
+            enemies->ai_target_id[index] = 0; // Player ID
+            update_enemy_memory(state, index, 0, state->player.x, state->player.y);
+        }
+        
+        if (intent->flags & INTENT_MOVE) {
+            EnemyBrain* brain = enemy_store_peek_brain(enemies, index);
+            
+            if (is_walkable_world(state, intent->move_x, intent->move_y) &&
+                move_enemy(state, index, intent->move_x, intent->move_y)) {
+                if ((intent->flags & INTENT_PATH_STEP) && brain) brain->path_index++;
+            } else if ((intent->flags & INTENT_PATH_STEP) && brain) {
+                // Taken by an enemy resolved earlier (or the move failed), replan next turn
+                brain->path_length = 0;
+                brain->path_index = 0;
+            }
+        }
+        
+        if (intent->flags & INTENT_FORGET) {
+            enemy_store_release_brain(enemies, index);
+        }
     }
 }
 
+/**
+ * Process one turn of AI for a single enemy: decide, then resolve at once
+ * The scheduler decides for many enemies in parallel instead (see scheduler.h).
+ */
+void process_enemy_ai(GameState* state, int index, int turn) {
+    if (!state || index < 0 || index >= state->enemies.count) return;
+    
+    // Decode the enemy's surroundings and build their planes before deciding
+    int chunk_x, chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, state->enemies.x[index], state->enemies.y[index],
+                          &chunk_x, &chunk_y, &local_x, &local_y);
+    ChunkWindow window;
+    get_chunk_window(state, chunk_x, chunk_y, &window);
+    WorldChunk* home = window.chunks[4];
+    if (!home) return;
+    
+    FlowField* field = update_flow_field(state, state->player.x, state->player.y);
+    
+    EnemyIntent intent;
+    decide_enemy_ai(state, field, &home->path_buffers, index, turn, &intent);
+    resolve_enemy_ai(state, &intent, 1);
+}
+
 /**
  * Update faction relations
  */
@@ -1064,95 +1323,108 @@ void update_faction_relations(GameState* state) {
 /**
  * Check if an enemy can detect the player
  */
-int can_detect_player(GameState* state, AIEnemy* enemy) {
-    if (!state || !enemy) return 0;
+int can_detect_player(GameState* state, int index) {
+    if (!state || index < 0) return 0;
+    
+    EnemyStore* enemies = &state->enemies;
+    int x = enemies->x[index];
+    int y = enemies->y[index];
     
     // Calculate distance to player
-    int dx = state->player.x - enemy->base.x;
-    int dy = state->player.y - enemy->base.y;
+    int dx = state->player.x - x;
+    int dy = state->player.y - y;
     int distance = (int)sqrt(dx*dx + dy*dy);
     
     // Check if within detection radius
-    if (distance > enemy->detection_radius) return 0;
+    if (distance > enemies->detection_radius[index]) return 0;
     
-    // Check line of sight
-    return get_line_of_sight(state, enemy->base.x, enemy->base.y, 
-                           state->player.x, state->player.y);
+    // Sight is symmetric, so the enemy sees the player if the player sees it
+    return fov_visible(state, x, y);
 }
 
 /**
  * Update enemy's memory of an entity
  */
-void update_enemy_memory(GameState* state, AIEnemy* enemy, int entity_id, int x, int y) {
-    if (!state || !enemy) return;
+void update_enemy_memory(GameState* state, int index, int entity_id, int x, int y) {
+    if (!state || index < 0) return;
+    
+    EnemyBrain* brain = enemy_store_brain(&state->enemies, index);
+    if (!brain) return;
     
     // Look for existing memory of this entity
-    for (int i = 0; i < enemy->memory_count; i++) {
-        if (enemy->memories[i].entity_id == entity_id) {
+    for (int i = 0; i < brain->memory_count; i++) {
+        if (brain->memories[i].entity_id == entity_id) {
             // Update existing memory
-            enemy->memories[i].x = x;
-            enemy->memories[i].y = y;
-            enemy->memories[i].time_seen = state->world.world_time;
+            brain->memories[i].x = x;
+            brain->memories[i].y = y;
+            brain->memories[i].time_seen = state->world.world_time;
             return;
         }
     }
     
     // Add new memory if we have space
-    if (enemy->memory_count < 10) {
-        enemy->memories[enemy->memory_count].entity_id = entity_id;
-        enemy->memories[enemy->memory_count].x = x;
-        enemy->memories[enemy->memory_count].y = y;
-        enemy->memories[enemy->memory_count].time_seen = state->world.world_time;
-        enemy->memory_count++;
+    if (brain->memory_count < ENEMY_MAX_MEMORIES) {
+        brain->memories[brain->memory_count].entity_id = entity_id;
+        brain->memories[brain->memory_count].x = x;
+        brain->memories[brain->memory_count].y = y;
+        brain->memories[brain->memory_count].time_seen = state->world.world_time;
+        brain->memory_count++;
     } else {
         // Replace oldest memory
         int oldest = 0;
         time_t oldest_time = state->world.world_time;
         
-        for (int i = 0; i < enemy->memory_count; i++) {
-            if (enemy->memories[i].time_seen < oldest_time) {
+        for (int i = 0; i < brain->memory_count; i++) {
+            if (brain->memories[i].time_seen < oldest_time) {
                 oldest = i;
-                oldest_time = enemy->memories[i].time_seen;
+                oldest_time = brain->memories[i].time_seen;
             }
         }
         
-        enemy->memories[oldest].entity_id = entity_id;
-        enemy->memories[oldest].x = x;
-        enemy->memories[oldest].y = y;
-        enemy->memories[oldest].time_seen = state->world.world_time;
+        brain->memories[oldest].entity_id = entity_id;
+        brain->memories[oldest].x = x;
+        brain->memories[oldest].y = y;
+        brain->memories[oldest].time_seen = state->world.world_time;
     }
 }
 
 /**
- * Calculate a path for an enemy to a target
+ * Calculate a path for an enemy to a target using A*
  */
-void calculate_path(GameState* state, AIEnemy* enemy, int target_x, int target_y) {
-    if (!state || !enemy) return;
+void calculate_path(GameState* state, int index, int target_x, int target_y) {
+    if (!state || index < 0) return;
     
-    // Very simple direct path for now - this would be replaced with proper A* pathfinding
-    enemy->path_length = 0;
-    enemy->path_index = 0;
+    EnemyBrain* brain = enemy_store_brain(&state->enemies, index);
+    if (!brain) return;
     
-    // Add current position as first point
-    enemy->path[enemy->path_length][0] = enemy->base.x;
-    enemy->path[enemy->path_length][1] = enemy->base.y;
-    enemy->path_length++;
-    
-    // Add target as final point
-    enemy->path[enemy->path_length][0] = target_x;
-    enemy->path[enemy->path_length][1] = target_y;
-    enemy->path_length++;
+    brain->path_index = 0;
+    brain->path_length = find_path(state, state->enemies.x[index], state->enemies.y[index],
+                                   target_x, target_y,
+                                   (PathHeuristic)state->world.path_heuristic,
+                                   brain->path, ENEMY_MAX_PATH);
 }
 
 /**
- * Simulate world changes in a chunk
+ * Whether a chunk has any world processes for simulate_world_chunk to run
+ * None exist yet. Chunks without any skip the copy of last turn and the
+ * work pool; add the check for a new process here along with the process.
+ */
+int chunk_has_world_processes(const WorldChunk* chunk) {
+    (void)chunk;
+    return 0;
+}
+
+/**
+ * Simulate world changes in a chunk for one turn
+ * Called only on turns the scheduler updates the chunk, and only for
+ * chunks where chunk_has_world_processes holds. Chunks may run in parallel
+ * (see scheduler.h): only this chunk's tiles may change, and anything read
+ * across its edge must come from CHUNK_TILE_BEFORE, last turn's copy, so
+ * the outcome doesn't depend on which chunk runs first.
  */
 void simulate_world_chunk(GameState* state, WorldChunk* chunk) {
     if (!state || !chunk) return;
     
-    // Update chunk's last_updated time
-    chunk->last_updated = time(NULL);
-    
     // Process events based on world state, e.g.,
     // - Growth of plants
     // - Water flow
@@ -1164,6 +1436,15 @@ void simulate_world_chunk(GameState* state, WorldChunk* chunk) {
 
 // Utility functions
 
+/**
+ * Charge the time since *start to a phase and restart the clock
+ */
+void end_sim_phase(GameState* state, SimPhase phase, double* start) {
+    double now = platform_time_ms();
+    state->phase_ms[phase] += now - *start;
+    *start = now;
+}
+
 /**
  * Log a game event
  */
@@ -1188,7 +1469,7 @@ int get_distance(int x1, int y1, int x2, int y2) {
 }
 
 /**
- * Check if there's a line of sight between two points
+ * Check if there's a line of sight between two world positions
  */
 int get_line_of_sight(GameState* state, int x1, int y1, int x2, int y2) {
     if (!state) return 0;
@@ -1216,8 +1497,8 @@ int get_line_of_sight(GameState* state, int x1, int y1, int x2, int y2) {
             continue;
         
         // Check if this tile blocks line of sight
-        WorldTile* tile = get_tile(state, x1, y1);
-        if (tile && !tile->transparent)
+        WorldTile* tile = get_tile_world(state, x1, y1);
+        if (tile && !tile_transparent(tile))
             return 0;
     }
     
@@ -1227,10 +1508,10 @@ int get_line_of_sight(GameState* state, int x1, int y1, int x2, int y2) {
 /**
  * Roll dice with a specific number of dice and sides
  */
-int roll_dice(int num_dice, int num_sides) {
+int roll_dice(Rng* rng, int num_dice, int num_sides) {
     int result = 0;
     for (int i = 0; i < num_dice; i++) {
-        result += (rand() % num_sides) + 1;
+        result += rng_range(rng, num_sides) + 1;
     }
     return result;
 }
@@ -1238,6 +1519,6 @@ int roll_dice(int num_dice, int num_sides) {
 /**
  * Check if an event with a specific probability happens
  */
-int chance(float probability) {
-    return (rand() / (float)RAND_MAX) < probability;
+int chance(Rng* rng, float probability) {
+    return rng_float(rng) < probability;
 }
\ No newline at end of file
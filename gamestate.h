@@ -8,22 +8,22 @@
 
 // Include enemy.h first to avoid redefinition issues
 #include "enemy.h"
+#include "rng.h"
+#include "enemystore.h"
+#include "itemstore.h"
+#include "tileplanes.h"
 
 // Forward declarations
 struct WorldTile;
 struct WorldChunk;
 struct World;
 struct GameState;
-
-// Define item type here to avoid circular dependencies
-typedef struct GameItem {
-    char name[32];      // Item name
-    char icon;          // Display character
-    int value;          // Value (for selling/buying)
-    double weight;      // Weight
-    int type;           // Type of item
-    int properties[10]; // Various properties based on type
-} GameItem;
+struct PathBuffers;
+struct FlowField;
+struct ChunkFov;
+struct SaveMapping;
+struct SaveJob;
+struct WorkPool;
 
 // Tile types
 typedef enum {
@@ -35,25 +35,73 @@ typedef enum {
     TILE_LAVA = 5
 } TileType;
 
-// Represents a single tile in the world
+// Tile flag bits
+#define TILE_FLAG_WALKABLE    0x01  // The tile can be walked on
+#define TILE_FLAG_TRANSPARENT 0x02  // The tile allows light to pass through
+
+// Alignment of chunk tile storage (one cache line)
+#define CHUNK_TILE_ALIGNMENT 64
+
+// Represents a single tile in the world (8 bytes)
 typedef struct WorldTile {
-    TileType type;          // Type of tile
-    char display_char;      // Character to display
-    int walkable;           // Whether the tile can be walked on
-    int transparent;        // Whether the tile allows light to pass through
-    int entity_id;          // ID of entity on this tile (0 = no entity)
-    int item_id;            // ID of item on this tile (0 = no item)
+    unsigned char type;         // TileType of the tile
+    char display_char;          // Character to display
+    unsigned char flags;        // TILE_FLAG_* bits
+    unsigned char reserved;     // Padding, keeps the ids 2-byte aligned
+    unsigned short entity_id;   // ID of entity on this tile (0 = no entity)
+    unsigned short item_id;     // ID of item on this tile (0 = no item)
 } WorldTile;
 
 // A chunk of the world (for larger worlds)
 typedef struct WorldChunk {
     int x, y;               // Chunk coordinates
-    WorldTile** tiles;      // 2D array of tiles
+    WorldTile* tiles;       // Contiguous row-major tiles (width * height), NULL until materialized
+    const WorldTile* mapped_tiles;    // Tile block inside a memory-mapped save (NULL if none)
+    const unsigned char* packed;      // Compressed tiles while dormant or still in the save (NULL if none)
+    size_t packed_size;               // Size of the packed tiles in bytes
+    int packed_owned;                 // packed is a heap buffer rather than part of the save mapping
     int width, height;      // Dimensions of this chunk
     int active;             // Whether this chunk is currently active
     time_t last_updated;    // When this chunk was last updated
+    struct PathBuffers* path_buffers; // Reusable A* search buffers (lazily allocated)
+    struct FlowField* flow_field;     // Distance map toward the player (lazily allocated)
+    struct ChunkFov* fov;             // What the player sees and has seen here (lazily allocated)
+    TilePlanes* planes;               // Walkable/transparent/occupied bits (lazily built)
+    WorldTile* sim_before;            // Last turn's tiles plus a one-tile border, for world processes (lazily allocated)
+    unsigned int walk_version;        // Bumped whenever walkability of a tile changes
+    int dirty;                        // Tiles changed since the chunk was last saved
+    unsigned short item_head;         // First item in the chunk's item list (tile id, 0 = none)
 } WorldChunk;
 
+// Tile accessors
+#define CHUNK_TILE(chunk, x, y) (&(chunk)->tiles[(y) * (chunk)->width + (x)])
+
+// Last turn's tile at a local position, -1 to width/height reaching into the neighbours
+#define CHUNK_TILE_BEFORE(chunk, x, y) \
+    (&(chunk)->sim_before[((y) + 1) * ((chunk)->width + 2) + (x) + 1])
+
+static inline int tile_walkable(const WorldTile* tile) {
+    return tile->flags & TILE_FLAG_WALKABLE;
+}
+
+static inline int tile_transparent(const WorldTile* tile) {
+    return (tile->flags & TILE_FLAG_TRANSPARENT) != 0;
+}
+
+/**
+ * A chunk's walkable/transparent/occupied planes, built on first use
+ * NULL if the chunk's tiles aren't loaded or memory runs out
+ */
+static inline TilePlanes* chunk_planes(WorldChunk* chunk) {
+    TilePlanes* planes = chunk->planes;
+    return planes && planes->valid ? planes : build_chunk_planes(chunk);
+}
+
+static inline void tile_set_flags(WorldTile* tile, int walkable, int transparent) {
+    tile->flags = (unsigned char)((walkable ? TILE_FLAG_WALKABLE : 0) |
+                                  (transparent ? TILE_FLAG_TRANSPARENT : 0));
+}
+
 // Represents a complete world
 typedef struct World {
     char name[64];          // World name
@@ -61,13 +109,90 @@ typedef struct World {
     int chunk_count;        // Number of chunks
     int chunk_width;        // Width of a chunk
     int chunk_height;       // Height of a chunk
+    int chunk_shift_x;      // log2(chunk_width), or -1 if not a power of two
+    int chunk_shift_y;      // log2(chunk_height), or -1 if not a power of two
     int current_chunk_x;    // Current active chunk x
     int current_chunk_y;    // Current active chunk y
     int seed;               // World seed for procedural generation
     time_t world_time;      // In-game time
     int turn_counter;       // Number of turns passed
+    int path_heuristic;     // PathHeuristic used by enemy pathfinding
+    int* chunk_slots;       // Open-addressing index: chunk array index + 1 (0 = empty)
+    int chunk_slot_capacity;// Number of slots (power of two)
+    WorldChunk* last_chunk; // One-entry cache in front of the index
+    struct SaveMapping* mapping; // Save file backing lazily loaded chunks (NULL if none)
+    unsigned int save_serial;   // Identifies the full save that journal entries apply to
+    int journal_batches;    // Incremental saves since the last full save (-1 forces a full save)
+    int dormant_center_x;   // Player chunk the dormant chunks were last packed around
+    int dormant_center_y;
+    int dormant_ready;      // dormant_center_x/y are set
+    unsigned int terrain_version; // Bumped whenever a tile starts or stops blocking sight
+    unsigned int fov_stamp; // Bumped on every field of view recompute (0 = never computed)
+    int fov_x, fov_y;       // Where the field of view was computed from
+    unsigned int fov_terrain;   // terrain_version the field of view was computed against
 } World;
 
+// A 3x3 block of chunks around a centre chunk, for searches that cross chunk edges
+typedef struct ChunkWindow {
+    int origin_x, origin_y;         // World position of the window's top-left tile
+    int width, height;              // Window size in tiles
+    int chunk_width, chunk_height;  // Size of each chunk in the window
+    WorldChunk* chunks[9];          // Row-major chunks (NULL where not loaded)
+    TilePlanes* planes[9];          // Their planes (NULL where not loaded)
+} ChunkWindow;
+
+/**
+ * Split a world coordinate into chunk and local coordinates
+ * Uses shift/mask when chunk sizes are powers of two, floor division otherwise
+ */
+static inline void world_to_chunk_coords(const World* world, int x, int y,
+                                         int* chunk_x, int* chunk_y,
+                                         int* local_x, int* local_y) {
+    if (world->chunk_shift_x >= 0) {
+        *chunk_x = x >> world->chunk_shift_x;
+        *local_x = x & (world->chunk_width - 1);
+    } else {
+        int cx = x / world->chunk_width;
+        if (x % world->chunk_width < 0) cx--;
+        *chunk_x = cx;
+        *local_x = x - cx * world->chunk_width;
+    }
+    
+    if (world->chunk_shift_y >= 0) {
+        *chunk_y = y >> world->chunk_shift_y;
+        *local_y = y & (world->chunk_height - 1);
+    } else {
+        int cy = y / world->chunk_height;
+        if (y % world->chunk_height < 0) cy--;
+        *chunk_y = cy;
+        *local_y = y - cy * world->chunk_height;
+    }
+}
+
+/**
+ * Get a tile inside a chunk window (window-local coordinates, no bounds check)
+ */
+static inline WorldTile* window_tile(const ChunkWindow* window, int x, int y) {
+    int cx = x / window->chunk_width;
+    int cy = y / window->chunk_height;
+    WorldChunk* chunk = window->chunks[cy * 3 + cx];
+    if (!chunk) return NULL;
+    
+    return CHUNK_TILE(chunk, x - cx * window->chunk_width, y - cy * window->chunk_height);
+}
+
+/**
+ * Whether a tile inside a chunk window is walkable (window-local coordinates, no bounds check)
+ */
+static inline int window_walkable(const ChunkWindow* window, int x, int y) {
+    int cx = x / window->chunk_width;
+    int cy = y / window->chunk_height;
+    const TilePlanes* planes = window->planes[cy * 3 + cx];
+    if (!planes) return 0;
+    
+    return plane_test(planes, PLANE_WALKABLE, x - cx * window->chunk_width, y - cy * window->chunk_height);
+}
+
 // Extended player structure with more RPG attributes
 typedef struct Player {
     int id;                 // Unique ID
@@ -87,40 +212,47 @@ typedef struct Player {
     int status_effects[10]; // Active status effects
 } Player;
 
-// Extended enemy with AI attributes
-typedef struct AIEnemy {
-    enemy base;             // Base enemy structure
-    int id;                 // Unique ID
-    int faction_id;         // Which faction this enemy belongs to
-    int ai_state;           // Current AI state (patrolling, hunting, fleeing, etc.)
-    int ai_target_id;       // ID of current target
-    int detection_radius;   // How far this enemy can see
-    int memory_count;       // Number of things this enemy remembers
-    struct {
-        int entity_id;      // What was seen
-        int x, y;           // Where it was seen
-        time_t time_seen;   // When it was seen
-    } memories[10];         // Memory of things the enemy has seen
-    int path[64][2];        // Current path being followed
-    int path_length;        // Length of current path
-    int path_index;         // Current position in path
-    int behavior_flags;     // Behavior flags (aggressive, timid, etc.)
-    int last_action_time;   // When the enemy last took an action
-} AIEnemy;
+// Phases of update_game_state, timed for the headless report
+typedef enum {
+    PHASE_WORLD = 0,        // World processes and chunk packing
+    PHASE_FIELDS,           // Flow field toward the player and field of view
+    PHASE_DECIDE,           // Enemies choosing their moves (parallel)
+    PHASE_RESOLVE,          // Enemies applying their moves in order
+    PHASE_COUNT
+} SimPhase;
+
+// What an enemy does in a turn (EnemyIntent flags)
+#define INTENT_MOVE         0x01    // Step onto move_x, move_y
+#define INTENT_PATH_STEP    0x02    // The step is the next one of the brain's path
+#define INTENT_SPOTTED      0x04    // Saw the player: target and remember it
+#define INTENT_FORGET       0x08    // Gave up the chase: release the brain
+
+// An enemy's decision for one turn, made against the world as the turn began
+typedef struct EnemyIntent {
+    int index;              // Store index of the enemy
+    unsigned char ai_state; // AI state after the turn
+    unsigned char flags;    // INTENT_* bits
+    int move_x, move_y;     // Where it steps (INTENT_MOVE)
+} EnemyIntent;
 
 // Game state structure that holds everything
 typedef struct GameState {    Player player;          // The player
     World world;            // The world
-    int enemy_count;        // Number of enemies
-    AIEnemy* enemies;       // Dynamic array of enemies
-    int item_count;         // Number of items in the world
-    GameItem* items;        // Dynamic array of items
+    EnemyStore enemies;     // All enemies, one array per field
+    ItemStore items;        // All items, on the map or not
+    int enemies_dirty;      // Enemy list changed since the last save
+    int items_dirty;        // Item list changed since the last save
     int active_effects;     // Global effects currently active
     char save_file[256];    // Path to save file
     int is_loaded;          // Whether game state is loaded
     time_t real_start_time; // When the game was started
     int paused;             // Whether the game is paused
     int debug_mode;         // Whether debug mode is enabled
+    struct SaveJob* save_job;   // Background save in progress (NULL if none)
+    struct WorkPool* sim_pool;  // Threads simulating chunks and enemies (NULL = calling thread only)
+    struct PathBuffers** sim_path_buffers; // A* buffers, one per simulation thread (lazily allocated)
+    int sim_path_buffer_count;  // Length of sim_path_buffers
+    double phase_ms[PHASE_COUNT];   // Time spent in each SimPhase so far (milliseconds)
     // Additional fields can be added for future expansion
 } GameState;
 
@@ -129,49 +261,75 @@ typedef struct GameState {    Player player;          // The player
 // Initialization functions
 GameState* create_game_state();
 void init_world(GameState* state, int width, int height, int seed);
+void set_chunk_size(World* world, int width, int height);
+WorldChunk* create_chunk(int chunk_x, int chunk_y, int width, int height);
+void destroy_chunk(WorldChunk* chunk);
+int alloc_chunk_tiles(WorldChunk* chunk);
+void free_chunk_tiles(WorldChunk* chunk);
 void load_chunk(GameState* state, int chunk_x, int chunk_y);
 void unload_chunk(GameState* state, int chunk_x, int chunk_y);
 
 // Game state management
 int save_game(GameState* state, const char* filename);
+int save_game_incremental(GameState* state, const char* filename);
 int load_game(GameState* state, const char* filename);
 void update_game_state(GameState* state);
 void destroy_game_state(GameState* state);
-void world_to_engine(GameState* state);
-void engine_to_world(GameState* state);
 
 // World interaction
+void init_tile(WorldTile* tile, TileType type);
 void set_tile(GameState* state, int x, int y, TileType type);
 WorldTile* get_tile(GameState* state, int x, int y);
 int is_walkable(GameState* state, int x, int y);
+WorldChunk* get_chunk_for_world(GameState* state, int x, int y, int* local_x, int* local_y);
+WorldTile* get_tile_world(GameState* state, int x, int y);
+void set_tile_world(GameState* state, int x, int y, TileType type);
+int is_walkable_world(GameState* state, int x, int y);
+void get_chunk_window(GameState* state, int center_chunk_x, int center_chunk_y, ChunkWindow* window);
+const WorldTile* peek_tile_world(GameState* state, int x, int y);
+void peek_chunk_window(GameState* state, int center_chunk_x, int center_chunk_y, ChunkWindow* window);
 WorldChunk* get_chunk_at(GameState* state, int chunk_x, int chunk_y);
 int get_chunk_index(GameState* state, int chunk_x, int chunk_y);
+void rebuild_chunk_index(World* world);
 
 // Entity management
 void move_entity(GameState* state, int entity_id, int new_x, int new_y);
 int add_enemy(GameState* state, AIEnemy enemy);
 void remove_enemy(GameState* state, int enemy_id);
-AIEnemy* get_enemy(GameState* state, int enemy_id);
-AIEnemy* get_enemy_at(GameState* state, int x, int y);
+int get_enemy(GameState* state, int enemy_id);
+int get_enemy_at(GameState* state, int x, int y);
+int get_enemies_in_radius(GameState* state, int x, int y, int radius, int* out, int max_out);
+int get_enemies_in_rect(GameState* state, int min_x, int min_y, int max_x, int max_y,
+                        int* out, int max_out);
 
 // Item management
 int add_item(GameState* state, GameItem new_item, int x, int y);
 GameItem* get_item(GameState* state, int item_id);
 void remove_item(GameState* state, int item_id);
+int get_item_at(GameState* state, int x, int y);
+int get_item_below(GameState* state, int item_id);
+int get_chunk_item(GameState* state, WorldChunk* chunk);
+int get_next_chunk_item(GameState* state, int item_id);
+void rebuild_item_links(GameState* state);
 
 // AI and simulation
-void process_enemy_ai(GameState* state, AIEnemy* enemy);
+void process_enemy_ai(GameState* state, int index, int turn);
+void decide_enemy_ai(GameState* state, const struct FlowField* field, struct PathBuffers** path_buffers,
+                     int index, int turn, EnemyIntent* intent);
+void resolve_enemy_ai(GameState* state, const EnemyIntent* intents, int count);
 void update_faction_relations(GameState* state);
-int can_detect_player(GameState* state, AIEnemy* enemy);
-void update_enemy_memory(GameState* state, AIEnemy* enemy, int entity_id, int x, int y);
-void calculate_path(GameState* state, AIEnemy* enemy, int target_x, int target_y);
+int can_detect_player(GameState* state, int index);
+void update_enemy_memory(GameState* state, int index, int entity_id, int x, int y);
+void calculate_path(GameState* state, int index, int target_x, int target_y);
+int chunk_has_world_processes(const WorldChunk* chunk);
 void simulate_world_chunk(GameState* state, WorldChunk* chunk);
 
 // Utility functions
+void end_sim_phase(GameState* state, SimPhase phase, double* start);
 void log_game_event(GameState* state, const char* format, ...);
 int get_distance(int x1, int y1, int x2, int y2);
 int get_line_of_sight(GameState* state, int x1, int y1, int x2, int y2);
-int roll_dice(int num_dice, int num_sides);
-int chance(float probability);
+int roll_dice(Rng* rng, int num_dice, int num_sides);
+int chance(Rng* rng, float probability);
 
 #endif /* GAMESTATE_H */
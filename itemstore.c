@@ -0,0 +1,86 @@
+#include "itemstore.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Make room for entries up to the slot map's slot count
+ */
+static int item_store_reserve(ItemStore* store, int capacity) {
+    if (capacity <= store->capacity) return 1;
+    
+    int new_capacity = store->capacity ? store->capacity : 16;
+    while (new_capacity < capacity) new_capacity *= 2;
+    
+    ItemEntry* entries = (ItemEntry*)realloc(store->entries, (size_t)new_capacity * sizeof(ItemEntry));
+    if (!entries) return 0;
+    
+    store->entries = entries;
+    store->capacity = new_capacity;
+    return 1;
+}
+
+/**
+ * Add an item that isn't on the map yet; returns its slot or -1
+ * A handle of 0 gets a fresh one; a handle from a save is kept
+ */
+int item_store_add(ItemStore* store, const GameItem* item, int handle) {
+    if (!store || !item) return -1;
+    
+    int id = slot_map_claim(&store->handles, handle, 0);
+    if (id == 0) return -1;
+    
+    int slot = handle_slot(id);
+    store->handles.slots[slot].value = slot;
+    if (!item_store_reserve(store, store->handles.slot_count)) {
+        slot_map_release(&store->handles, slot);
+        return -1;
+    }
+    
+    ItemEntry* entry = &store->entries[slot];
+    entry->item = *item;
+    entry->x = ITEM_NOWHERE;
+    entry->y = ITEM_NOWHERE;
+    entry->below = 0;
+    entry->chunk_prev = 0;
+    entry->chunk_next = 0;
+    store->count++;
+    
+    return slot;
+}
+
+/**
+ * Free an item's slot (unlink it from the map first)
+ */
+void item_store_remove(ItemStore* store, int slot) {
+    if (!store || slot_map_find(&store->handles, slot + 1) != slot) return;
+    
+    slot_map_release(&store->handles, slot);
+    store->count--;
+}
+
+/**
+ * Copy every item and the slot map into an empty store
+ */
+int item_store_copy(ItemStore* dst, const ItemStore* src) {
+    memset(dst, 0, sizeof(ItemStore));
+    
+    if (!slot_map_copy(&dst->handles, &src->handles) ||
+        !item_store_reserve(dst, src->handles.slot_count)) {
+        item_store_clear(dst);
+        return 0;
+    }
+    
+    if (src->handles.slot_count > 0)
+        memcpy(dst->entries, src->entries, (size_t)src->handles.slot_count * sizeof(ItemEntry));
+    dst->count = src->count;
+    return 1;
+}
+
+/**
+ * Free the store and reset it to empty
+ */
+void item_store_clear(ItemStore* store) {
+    slot_map_clear(&store->handles);
+    free(store->entries);
+    memset(store, 0, sizeof(ItemStore));
+}
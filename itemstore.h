@@ -0,0 +1,63 @@
+#ifndef ITEMSTORE_H
+#define ITEMSTORE_H
+
+#include <limits.h>
+#include "slotmap.h"
+
+/*
+ * Items live in a slot-indexed pool with stable handles (see slotmap.h).
+ * An item on the map is linked into two lists, both by tile id (slot + 1):
+ *
+ *   - its tile's stack: WorldTile::item_id is the top item, each item
+ *     points to the one below it
+ *   - its chunk's item list, headed by WorldChunk::item_head
+ *
+ * so placing or removing an item touches only its own tile and neighbours.
+ */
+
+#define ITEM_NOWHERE    INT_MIN         // Position of an item that isn't on the map
+#define ITEM_UNKNOWN    (INT_MIN + 1)   // Position not known yet (older saves), found by a tile scan
+
+// Define item type here to avoid circular dependencies
+typedef struct GameItem {
+    char name[32];      // Item name
+    char icon;          // Display character
+    int value;          // Value (for selling/buying)
+    double weight;      // Weight
+    int type;           // Type of item
+    int properties[10]; // Various properties based on type
+} GameItem;
+
+// Per-slot item data
+typedef struct ItemEntry {
+    GameItem item;          // The item
+    int x, y;               // World position, or ITEM_NOWHERE / ITEM_UNKNOWN
+    unsigned short below;   // Next item down the same tile's stack (0 = bottom)
+    unsigned short chunk_prev;  // Neighbours in the chunk's item list (0 = none)
+    unsigned short chunk_next;
+} ItemEntry;
+
+// All items
+typedef struct ItemStore {
+    SlotMap handles;        // Handle -> slot
+    ItemEntry* entries;     // One per slot
+    int capacity;           // Allocated entries
+    int count;              // Number of live items
+} ItemStore;
+
+// Membership
+int item_store_add(ItemStore* store, const GameItem* item, int handle);
+void item_store_remove(ItemStore* store, int slot);
+
+/**
+ * Full handle of the item in a live slot
+ */
+static inline int item_store_handle(const ItemStore* store, int slot) {
+    return store->handles.slots[slot].generation << 16 | (slot + 1);
+}
+
+// Whole store
+int item_store_copy(ItemStore* dst, const ItemStore* src);
+void item_store_clear(ItemStore* store);
+
+#endif /* ITEMSTORE_H */
@@ -0,0 +1,281 @@
+#include "level.h"
+
+// A checked level: rows point into the file buffer
+typedef struct LevelLayout {
+    int width, height;      // Size in tiles
+    long* rows;             // Buffer offset of each row
+    int player_x, player_y; // Player start, or -1 if the level has none
+} LevelLayout;
+
+/**
+ * Read a whole file into one NUL-terminated buffer
+ */
+static char* read_level_file(const char* filename, long* size) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) return NULL;
+
+    char* buffer = NULL;
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) length = ftell(file);
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        buffer = (char*)malloc((size_t)length + 1);
+        if (buffer && fread(buffer, 1, (size_t)length, file) != (size_t)length) {
+            free(buffer);
+            buffer = NULL;
+        }
+    }
+    fclose(file);
+
+    if (buffer) {
+        buffer[length] = '\0';
+        *size = length;
+    }
+    return buffer;
+}
+
+/**
+ * Whether a character is a known level cell
+ */
+static int level_cell_valid(char c) {
+    return c == 'w' || c == '0' || c == 'G' || c == '@';
+}
+
+/**
+ * Parse blanks followed by a decimal number, capped past LEVEL_MAX_SIDE
+ * Returns -1 if there is no number
+ */
+static long parse_level_number(const char** p) {
+    const char* q = *p;
+    while (*q == ' ' || *q == '\t') q++;
+    if (*q < '0' || *q > '9') return -1;
+
+    long value = 0;
+    for (; *q >= '0' && *q <= '9'; q++) {
+        if (value <= LEVEL_MAX_SIDE) value = value * 10 + (*q - '0');
+    }
+    *p = q;
+    return value;
+}
+
+/**
+ * Parse "LVL <width> <height>" and step past its line break
+ * Returns 1 if there is a valid header, 0 if there is none, -1 if it is malformed
+ */
+static int parse_level_header(const char* buffer, long size, long* pos, LevelLayout* layout) {
+    if (size < 3 || memcmp(buffer, LEVEL_MAGIC, 3) != 0) return 0;
+
+    const char* p = buffer + 3;
+    if (*p != ' ' && *p != '\t') return -1;
+    long width = parse_level_number(&p);
+    long height = parse_level_number(&p);
+
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '\r') p++;
+    if (*p != '\n') return -1;
+    p++;
+
+    if (width < 1 || height < 1 || width > LEVEL_MAX_SIDE || height > LEVEL_MAX_SIDE) return -1;
+    layout->width = (int)width;
+    layout->height = (int)height;
+    *pos = p - buffer;
+    return 1;
+}
+
+/**
+ * Check every row and cell of a level and record where the rows start
+ * Prints what is wrong and returns 0 on malformed input
+ */
+static int parse_level(const char* filename, const char* buffer, long size, LevelLayout* layout) {
+    long pos = 0;
+    int header = parse_level_header(buffer, size, &pos, layout);
+    if (header < 0) {
+        printf("Level %s: bad header, expected \"%s <width> <height>\" (sides 1-%d)\n",
+               filename, LEVEL_MAGIC, LEVEL_MAX_SIDE);
+        return 0;
+    }
+    if (header == 0) {
+        // Legacy levels are as tall as their cells allow
+        long cells = 0;
+        for (long i = 0; i < size; i++) {
+            char c = buffer[i];
+            if (c != '\n' && c != '\r' && c != ' ' && c != '\t') cells++;
+        }
+        if (cells == 0 || cells % LEVEL_LEGACY_WIDTH != 0 || cells / LEVEL_LEGACY_WIDTH > LEVEL_MAX_SIDE) {
+            printf("Level %s: %ld cells do not make rows of %d\n", filename, cells, LEVEL_LEGACY_WIDTH);
+            return 0;
+        }
+        layout->width = LEVEL_LEGACY_WIDTH;
+        layout->height = (int)(cells / LEVEL_LEGACY_WIDTH);
+    }
+
+    layout->player_x = -1;
+    layout->player_y = -1;
+    layout->rows = (long*)malloc(layout->height * sizeof(long));
+    if (!layout->rows) {
+        printf("Level %s: out of memory\n", filename);
+        return 0;
+    }
+
+    // Line and column are only tracked for error messages
+    int line = header ? 2 : 1;
+    long line_start = pos;
+
+    for (int y = 0; y < layout->height; y++) {
+        if (pos >= size) {
+            printf("Level %s: only %d of %d rows\n", filename, y, layout->height);
+            return 0;
+        }
+        layout->rows[y] = pos;
+
+        for (int x = 0; x < layout->width; x++, pos++) {
+            char c = pos < size ? buffer[pos] : '\n';
+            if (c == '\n' || c == '\r') {
+                printf("Level %s:%d: row %d has %d cells, expected %d\n",
+                       filename, line, y + 1, x, layout->width);
+                return 0;
+            }
+            if (!level_cell_valid(c)) {
+                printf("Level %s:%d:%ld: unexpected character 0x%02x\n",
+                       filename, line, pos - line_start + 1, (unsigned char)c);
+                return 0;
+            }
+            if (c == '@') {
+                if (layout->player_x >= 0) {
+                    printf("Level %s:%d:%ld: second player start\n",
+                           filename, line, pos - line_start + 1);
+                    return 0;
+                }
+                layout->player_x = x;
+                layout->player_y = y;
+            }
+        }
+
+        // Rows end in a line break; legacy levels may run them together
+        if (pos < size && buffer[pos] == '\r') pos++;
+        if (pos < size && buffer[pos] == '\n') {
+            pos++;
+            line++;
+            line_start = pos;
+        } else if (header && pos < size) {
+            printf("Level %s:%d: row %d is longer than %d cells\n",
+                   filename, line, y + 1, layout->width);
+            return 0;
+        }
+    }
+
+    // Only blank space may follow the last row
+    for (; pos < size; pos++) {
+        char c = buffer[pos];
+        if (c == '\n') {
+            line++;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            printf("Level %s:%d: data after the last of %d rows\n", filename, line, layout->height);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Add a goblin at a world position
+ */
+static void spawn_goblin(GameState* state, int x, int y) {
+    AIEnemy goblin;
+    memset(&goblin, 0, sizeof(AIEnemy));
+    goblin.base.x = x;
+    goblin.base.y = y;
+    goblin.base.health = 10;
+    goblin.base.icon = 'G';
+    goblin.base.name = "Goblin";
+    goblin.faction_id = 1;          // Default faction
+    goblin.ai_state = 0;            // Idle
+    goblin.detection_radius = 5;
+    add_enemy(state, goblin);
+}
+
+/**
+ * Write a checked level into the world, one chunk at a time
+ */
+static int fill_level(GameState* state, const char* buffer, const LevelLayout* layout) {
+    int chunk_width = state->world.chunk_width;
+    int chunk_height = state->world.chunk_height;
+    int chunks_x = (layout->width + chunk_width - 1) / chunk_width;
+    int chunks_y = (layout->height + chunk_height - 1) / chunk_height;
+
+    for (int cy = 0; cy < chunks_y; cy++) {
+        for (int cx = 0; cx < chunks_x; cx++) {
+            load_chunk(state, cx, cy);
+            WorldChunk* chunk = get_chunk_at(state, cx, cy);
+            if (!chunk) return 0;
+
+            int origin_x = cx * chunk_width;
+            int origin_y = cy * chunk_height;
+            for (int y = 0; y < chunk_height; y++) {
+                int world_y = origin_y + y;
+                const char* row = world_y < layout->height ? buffer + layout->rows[world_y] : NULL;
+
+                for (int x = 0; x < chunk_width; x++) {
+                    int world_x = origin_x + x;
+                    WorldTile* tile = CHUNK_TILE(chunk, x, y);
+                    if (!row || world_x >= layout->width) {
+                        init_tile(tile, TILE_EMPTY);
+                        continue;
+                    }
+
+                    char c = row[world_x];
+                    init_tile(tile, c == 'w' ? TILE_WALL : TILE_FLOOR);
+                    if (c == 'G') spawn_goblin(state, world_x, world_y);
+                }
+            }
+
+            chunk->dirty = 1;
+            chunk->walk_version++;
+            invalidate_chunk_planes(chunk);
+        }
+    }
+
+    state->world.terrain_version++;
+    return 1;
+}
+
+/**
+ * Load a level file into an initialized world
+ * Returns 1 on success, 0 if the file can't be read or is malformed
+ */
+int load_level(GameState* state, const char* filename) {
+    if (!state || !filename || state->world.chunk_width <= 0) return 0;
+
+    long size = 0;
+    char* buffer = read_level_file(filename, &size);
+    if (!buffer) {
+        printf("Could not read level file: %s\n", filename);
+        return 0;
+    }
+
+    LevelLayout layout = {0};
+    int ok = parse_level(filename, buffer, size, &layout);
+    if (ok) {
+        ok = fill_level(state, buffer, &layout);
+        if (!ok) printf("Level %s: out of memory\n", filename);
+    }
+
+    if (ok) {
+        if (layout.player_x >= 0) {
+            state->player.x = layout.player_x;
+            state->player.y = layout.player_y;
+        }
+
+        // The player's chunk is the current one
+        int local_x, local_y;
+        world_to_chunk_coords(&state->world, state->player.x, state->player.y,
+                              &state->player.chunk_x, &state->player.chunk_y,
+                              &local_x, &local_y);
+        state->world.current_chunk_x = state->player.chunk_x;
+        state->world.current_chunk_y = state->player.chunk_y;
+    }
+
+    free(layout.rows);
+    free(buffer);
+    return ok;
+}
@@ -0,0 +1,28 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "gamestate.h"
+
+/*
+ * Level files (.lvl):
+ *
+ *   header:  "LVL <width> <height>" on the first line
+ *   rows:    height rows of exactly width cells, each row ended by a line break
+ *
+ *   cells:   'w' wall, '0' floor, 'G' goblin on floor, '@' player start on floor
+ *
+ * Files without a header are legacy maps LEVEL_LEGACY_WIDTH cells wide and
+ * as many rows tall as the file holds; line breaks between rows are
+ * optional. The whole file is read into one buffer and checked before the
+ * world is touched, so a malformed level leaves the game state as it was.
+ * Tiles are written chunk by chunk into the world starting at (0, 0); parts
+ * of edge chunks outside the level become TILE_EMPTY.
+ */
+
+#define LEVEL_MAGIC         "LVL"
+#define LEVEL_LEGACY_WIDTH  20
+#define LEVEL_MAX_SIDE      16384   // Largest width or height accepted
+
+int load_level(GameState* state, const char* filename);
+
+#endif /* LEVEL_H */
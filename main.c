@@ -1,22 +1,77 @@
 
 #include "gamestate.h"
+#include "savegame.h"
 #include "engine.h"
-#include <time.h>  // For srand
+#include "level.h"
+#include "scheduler.h"
+#include "workpool.h"
+#include <time.h>  // For time
 
-// Global variables for player position (needed for enemy AI)
-int playerPosY = 3;
-int playerPosX = 3;
+// Turns between incremental autosaves
+#define AUTOSAVE_INTERVAL 20
+
+// How often to wake up and check on a background save while waiting for input
+#define SAVE_POLL_MS 50
+
+// Headless benchmark defaults
+#define HEADLESS_DEFAULT_TURNS 1000
+#define HEADLESS_MAX_INPUTS_PER_TURN 16
+
+// Time spent in each phase of a turn, in milliseconds
+typedef struct PhaseTimings {
+    double move;        // Player movement and combat
+    double render;      // drawMap and status output
+    double update;      // turn() and update_game_state(), which runs the enemies
+    long turns;         // Turns advanced
+} PhaseTimings;
+
+// Report rows for the SimPhases inside update_game_state, indented under it
+const char *simPhaseNames[PHASE_COUNT] = {"  world sim", "  flow field/FOV", "  AI decide",
+                                         "  AI resolve"};
+
+// Run without a terminal (--headless)
+int headless = 0;
+
+// Seed for every random stream in the game
+unsigned int worldSeed = 0;
 
 // Function prototypes
 void displayPlayerStatus(Player *user);
-void processEnemyTurns();
 void showMainMenu(GameState *state);
 void loadLevelFromFile(GameState *state, const char *filename);
 void handleInput(GameState *state, Player *user, int *gameRunning);
+void processKey(GameState *gameState, Player *user, char ch, int *gameRunning, PhaseTimings *timings);
+int runHeadless(GameState *gameState, Player *user, const char *scriptFile, long turns, unsigned int seed);
+void printPhaseRow(const char *name, double total, long turns, double elapsed);
 
-int main(void) {
-    // Initialize random seed
-    srand(time(NULL));
+int main(int argc, char *argv[]) {
+    // Command line options
+    const char *scriptFile = NULL;
+    const char *levelFile = "2.lvl";
+    long headlessTurns = HEADLESS_DEFAULT_TURNS;
+    unsigned int seed = (unsigned int)time(NULL);
+    int simThreads = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        } else if (strcmp(argv[i], "--turns") == 0 && i + 1 < argc) {
+            headlessTurns = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            scriptFile = argv[++i];
+        } else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            levelFile = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            simThreads = atoi(argv[++i]);
+        } else {
+            printf("Usage: %s [--level FILE] [--threads N] [--headless [--turns N] [--seed N] [--script FILE]]\n", argv[0]);
+            return 1;
+        }
+    }
+    
+    worldSeed = seed;
     
     // Create game state
     GameState *gameState = create_game_state();
@@ -36,127 +91,49 @@ int main(void) {
     playerInventory.size = 0;
     playerInventory.contents = NULL;
 
-    // Load Level
-    FILE *fptr;
-    fptr = fopen("2.lvl", "r");
-    if(fptr == NULL) {
-      printf("Error! No level file in directory!");   
-      exit(1);             
+    // Build the game world straight from the level
+    init_world(gameState, WIDTH, HEIGHT, seed);
+    double loadStart = platform_time_ms();
+    if (!load_level(gameState, levelFile)) {
+      printf("Error! Could not load level %s\n", levelFile);
+      destroy_game_state(gameState);
+      exit(1);
     }
-    printf("Loaded Level\n");
-    
-    // Initialize the game world
-    initLevel(fptr);
+    printf("Loaded Level in %.3f ms\n", platform_time_ms() - loadStart);
     
-    // Copy current level data to game state
-    init_world(gameState, WIDTH, HEIGHT, time(NULL));
-    engine_to_world(gameState);
+    if (!set_sim_threads(gameState, simThreads)) {
+      printf("Could not start %d simulation threads, using 1\n", simThreads);
+    }
     
-    // Set player position
-    gameState->player.x = playerPosX;
-    gameState->player.y = playerPosY;
-    world[playerPosY][playerPosX] = '@';
+    if (headless) {
+        int result = runHeadless(gameState, &user, scriptFile, headlessTurns, seed);
+        destroy_game_state(gameState);
+        return result;
+    }
     
     initColor();
 
-    drawMap(playerPosY, playerPosX);
+    drawMap(gameState);
     displayPlayerStatus(&user);    // Game loop
+    PhaseTimings timings = {0};
     while (gameRunning) {
-        char ch;
-
-        if (kbhit()) {
-            world[playerPosY][playerPosX] = '.'; // restore last cell
-            ch = getch();
-
-            int newY = playerPosY;
-            int newX = playerPosX;
-
-            // Determine new position based on key
-            switch(ch) {
-                case 'w': newY--; break;
-                case 'a': newX--; break;
-                case 's': newY++; break;
-                case 'd': newX++; break;
-                case 'q': gameRunning = 0; break;  // Quit game
-                case 'z': // Save game
-                    save_game(gameState, "savegame.sav");
-                    break;
-                case 'x': // Load game
-                    if (load_game(gameState, "savegame.sav")) {
-                        world_to_engine(gameState);
-                        playerPosX = gameState->player.x;
-                        playerPosY = gameState->player.y;
-                        user.health = gameState->player.health;
-                        user.max_health = gameState->player.max_health;
-                        user.level = gameState->player.level;
-                        drawMap(playerPosY, playerPosX);
-                        displayPlayerStatus(&user);
-                    }
-                    break;
-                default: break;
-            }            // Check if new position is valid
-            if (newY >= 0 && newY < HEIGHT && newX >= 0 && newX < WIDTH && 
-                collisionMap[newY][newX] != 1 && ch != 'q') {
-                
-                // Check for enemy at new position
-                int enemyEncountered = 0;
-                for (int i = 0; i < enemyCount; i++) {
-                    if (enemyList[i]->y == newY && enemyList[i]->x == newX) {
-                        // Combat - reduce enemy health, simplistic for now
-                        printf("\nYou attack the %s!\n", enemyList[i]->name);
-                        
-                        // Update player stats in game state
-                        gameState->player.health -= 2;
-                        user.health = gameState->player.health;
-                        
-                        enemyEncountered = 1;
-                        
-                        // Remove the enemy (for now - could expand to health system)
-                        world[enemyList[i]->y][enemyList[i]->x] = '.';
-                        
-                        // Remove from game state
-                        AIEnemy* enemy = get_enemy_at(gameState, newX, newY);
-                        if (enemy) {
-                            WorldTile* tile = get_tile(gameState, newX, newY);
-                            if (tile) tile->entity_id = 0;
-                        }
-                        
-                        // Move enemies to end and decrease count
-                        free(enemyList[i]);
-                        for (int j = i; j < enemyCount - 1; j++) {
-                            enemyList[j] = enemyList[j + 1];
-                        }
-                        enemyCount--;
-                        break;
-                    }
-                }
-                
-                if (!enemyEncountered) {
-                    playerPosY = newY;
-                    playerPosX = newX;
-                    
-                    // Update game state
-                    gameState->player.x = playerPosX;
-                    gameState->player.y = playerPosY;
-                }                world[playerPosY][playerPosX] = '@';
-                drawMap(playerPosY, playerPosX);
-                displayPlayerStatus(&user);
-                
-                // Advance game turn
-                turn();
-                processEnemyTurns();
-                
-                // Update game state
-                update_game_state(gameState);
-                
-                // Check for game over after turn
-                if(user.health <= 0) {
-                    printf("\nYou have died! Game over.\n");
-                    gameRunning = 0;
-                }
-            }
+        // Sleep until a key arrives; only wake early while a save is running
+        int key = platform_wait_key(gameState->save_job ? SAVE_POLL_MS : -1);
+        if (key == PLATFORM_KEY_EOF) {
+            // Input closed: quit rather than wake up forever
+            gameRunning = 0;
+        } else if (key >= 0) {
+            processKey(gameState, &user, (char)key, &gameRunning, &timings);
         }        
         
+        // Report background saves once they finish
+        SaveStatus saveStatus = poll_save(gameState);
+        if (saveStatus == SAVE_DONE) {
+            printf("\nGame saved\n");
+        } else if (saveStatus == SAVE_FAILED) {
+            printf("\nSave failed!\n");
+        }
+        
         // Check for end conditions and break out of the game loop if necessary
         if(user.health <= 0) {
             printf("\nYou have died! Game over.\n");
@@ -165,51 +142,192 @@ int main(void) {
     }    // Clean up and exit
     printf("\nThanks for playing!\n");
     destroy_game_state(gameState);
-    fclose(fptr);
     return 0;
 }
 
-// Display player stats
-void displayPlayerStatus(Player *user) {
-    printf("\nHealth: %d/%d | Level: %d\n", 
-           user->health, user->max_health, user->level);
-    printf("Controls: w,a,s,d to move, z to save, x to load, q to quit\n");
-}
+// Handle one key press: move or fight, then advance the turn
+void processKey(GameState *gameState, Player *user, char ch, int *gameRunning, PhaseTimings *timings) {
+    double phaseStart = platform_time_ms();
+
+    int newY = gameState->player.y;
+    int newX = gameState->player.x;
+    int moved = 0;
 
-// Process enemy turns
-void processEnemyTurns() {
-    // For each enemy, try to move towards the player
-    for (int i = 0; i < enemyCount; i++) {
-        // Save original position
-        int origX = enemyList[i]->x;
-        int origY = enemyList[i]->y;
+    // Determine new position based on key
+    switch(ch) {
+        case 'w': newY--; moved = 1; break;
+        case 'a': newX--; moved = 1; break;
+        case 's': newY++; moved = 1; break;
+        case 'd': newX++; moved = 1; break;
+        case 'q': *gameRunning = 0; break;  // Quit game
+        case 'z': // Save game in the background
+            save_game_async(gameState, "savegame.sav");
+            break;
+        case 'x': // Load game
+            if (load_game(gameState, "savegame.sav")) {
+                user->health = gameState->player.health;
+                user->max_health = gameState->player.max_health;
+                user->level = gameState->player.level;
+                if (!headless) {
+                    drawMap(gameState);
+                    displayPlayerStatus(user);
+                }
+            }
+            break;
+        default: break;
+    }
+    
+    // Fight whatever stands in the way, otherwise walk if the tile allows it;
+    // any other key except quit waits a turn in place
+    int target = moved ? get_enemy_at(gameState, newX, newY) : -1;
+    int blocked = ch == 'q' || (moved && target < 0 && !is_walkable_world(gameState, newX, newY));
+    if (!blocked) {
         
-        // Simple AI - move randomly (25% chance to move)
-        if (rand() % 4 == 0) {
-            int direction = rand() % 4; // 0=up, 1=right, 2=down, 3=left
-            int newX = origX;
-            int newY = origY;
+        if (target >= 0) {
+            // Combat - reduce enemy health, simplistic for now
+            if (!headless) printf("\nYou attack the %s!\n", gameState->enemies.name[target]);
             
-            switch(direction) {
-                case 0: newY--; break; // Up
-                case 1: newX++; break; // Right
-                case 2: newY++; break; // Down
-                case 3: newX--; break; // Left
-            }
+            // Update player stats in game state
+            gameState->player.health -= 2;
+            user->health = gameState->player.health;
+            
+            // Remove the enemy (for now - could expand to health system)
+            remove_enemy(gameState, gameState->enemies.id[target]);
+        } else if (moved) {
+            gameState->player.x = newX;
+            gameState->player.y = newY;
+        }
+        
+        double now = platform_time_ms();
+        timings->move += now - phaseStart;
+        phaseStart = now;
+        
+        if (!headless) {
+            drawMap(gameState);
+            displayPlayerStatus(user);
             
-            // Check if valid move
-            if (newY >= 0 && newY < HEIGHT && newX >= 0 && newX < WIDTH && 
-                collisionMap[newY][newX] != 1 && 
-                !(newY == playerPosY && newX == playerPosX)) { // Don't move onto player
-                
-                // Update world and enemy position
-                world[origY][origX] = '.';
-                enemyList[i]->x = newX;
-                enemyList[i]->y = newY;
-                world[newY][newX] = enemyList[i]->icon;
+            now = platform_time_ms();
+            timings->render += now - phaseStart;
+            phaseStart = now;
+        }
+        
+        // Advance game turn; enemies act inside update_game_state
+        turn();
+        update_game_state(gameState);
+        
+        now = platform_time_ms();
+        timings->update += now - phaseStart;
+        phaseStart = now;
+        timings->turns++;
+        
+        // Autosave only writes what changed since the last save
+        // (headless runs leave the player's save alone)
+        if (!headless && gameState->world.turn_counter % AUTOSAVE_INTERVAL == 0) {
+            save_game_async(gameState, "savegame.sav");
+        }
+        
+        // Check for game over after turn
+        if(user->health <= 0) {
+            if (!headless) printf("\nYou have died! Game over.\n");
+            *gameRunning = 0;
+        }
+    } else {
+        timings->move += platform_time_ms() - phaseStart;
+    }
+}
+
+// Run turns without a terminal, driven by a move script or seeded random moves
+int runHeadless(GameState *gameState, Player *user, const char *scriptFile, long turns, unsigned int seed) {
+    char *script = NULL;
+    long scriptLength = 0;
+    
+    // Keep only the movement keys from the script
+    if (scriptFile) {
+        FILE *file = fopen(scriptFile, "r");
+        if (!file) {
+            printf("Error! Could not open script: %s\n", scriptFile);
+            return 1;
+        }
+        
+        int c;
+        long capacity = 0;
+        while ((c = fgetc(file)) != EOF) {
+            if (c != 'w' && c != 'a' && c != 's' && c != 'd') continue;
+            if (scriptLength == capacity) {
+                capacity = capacity ? capacity * 2 : 256;
+                char *grown = (char *)realloc(script, capacity);
+                if (!grown) {
+                    printf("Error! Out of memory reading script: %s\n", scriptFile);
+                    fclose(file);
+                    free(script);
+                    return 1;
+                }
+                script = grown;
             }
+            script[scriptLength++] = (char)c;
         }
+        fclose(file);
+        
+        if (scriptLength == 0) {
+            printf("Error! Script has no moves: %s\n", scriptFile);
+            free(script);
+            return 1;
+        }
+    }
+    
+    PhaseTimings timings = {0};
+    int gameRunning = 1;
+    long inputs = 0;
+    
+    Rng inputRng;
+    rng_stream(&inputRng, seed, RNG_DOMAIN_INPUT, 0, 0);
+    
+    // Blocked moves don't advance the turn, so cap the inputs in case the player is walled in
+    long maxInputs = turns * HEADLESS_MAX_INPUTS_PER_TURN;
+    
+    double start = platform_time_ms();
+    while (gameRunning && timings.turns < turns && inputs < maxInputs) {
+        char ch = script ? script[inputs % scriptLength] : "wasd"[rng_range(&inputRng, 4)];
+        processKey(gameState, user, ch, &gameRunning, &timings);
+        inputs++;
+    }
+    double elapsed = platform_time_ms() - start;
+    
+    printf("Headless run: seed %u, %s, %d simulation thread(s)\n", seed, scriptFile ? scriptFile : "random moves",
+           work_pool_threads(gameState->sim_pool));
+    printf("%ld turns from %ld inputs in %.3f ms", timings.turns, inputs, elapsed);
+    if (elapsed > 0) printf(" (%.0f turns/sec)", timings.turns * 1000.0 / elapsed);
+    printf("\n");
+    if (user->health <= 0) printf("Player died on turn %ld\n", timings.turns);
+    
+    printf("%-18s %10s %10s %7s\n", "phase", "total ms", "us/turn", "share");
+    printPhaseRow("player move", timings.move, timings.turns, elapsed);
+    printPhaseRow("update state", timings.update, timings.turns, elapsed);
+    
+    // What update state spent its time on; the rest is turn bookkeeping and factions
+    double phased = 0;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        printPhaseRow(simPhaseNames[i], gameState->phase_ms[i], timings.turns, elapsed);
+        phased += gameState->phase_ms[i];
     }
+    printPhaseRow("  other", timings.update - phased, timings.turns, elapsed);
+    
+    free(script);
+    return 0;
+}
+
+// Print one row of the headless timing report
+void printPhaseRow(const char *name, double total, long turns, double elapsed) {
+    printf("%-18s %10.3f %10.2f %6.1f%%\n", name, total,
+           turns ? total * 1000.0 / turns : 0.0,
+           elapsed > 0 ? total * 100.0 / elapsed : 0.0);
+}
+
+// Display player stats
+void displayPlayerStatus(Player *user) {
+    printf("\nHealth: %d/%d | Level: %d\n", 
+           user->health, user->max_health, user->level);
+    printf("Controls: w,a,s,d to move, z to save, x to load, q to quit\n");
 }
 
 // Show main menu
@@ -218,7 +336,7 @@ void showMainMenu(GameState *state) {
     initColor();
     
     // Clear screen
-    system("cls");
+    platform_clear_screen();
     
     // Display menu
     printf("\033[93m =====================\n");
@@ -230,8 +348,10 @@ void showMainMenu(GameState *state) {
     printf(" 4. Quit\n\n");
     printf("\033[97m Enter your choice: ");
     
-    // Get user choice
-    char choice = getch();
+    // Get user choice; closed input quits
+    int key = platform_getch();
+    if (key == PLATFORM_KEY_EOF) exit(0);
+    char choice = (char)key;
     
     // Process choice
     switch(choice) {
@@ -246,14 +366,14 @@ void showMainMenu(GameState *state) {
             break;
         case '3':
             // Show credits
-            system("cls");
+            platform_clear_screen();
             printf("\033[93m =====================\n");
             printf(" =     CREDITS      =\n");
             printf(" =====================\n\n");
             printf("\033[96m Programming: Aidan\n");
             printf(" AI Assistance: GitHub Copilot\n\n");
             printf("\033[97m Press any key to return to menu...");
-            getch();
+            platform_getch();
             showMainMenu(state);
             break;
         case '4':
@@ -268,88 +388,17 @@ void showMainMenu(GameState *state) {
 
 // Load level from file
 void loadLevelFromFile(GameState *state, const char *filename) {
-    FILE *fptr = fopen(filename, "r");
-    if(fptr == NULL) {
-        printf("Error! Could not load level file: %s", filename);   
-        return;             
-    }
-    
-    // Initialize the game world
-    initLevel(fptr);
-    
-    // Copy data to game state
-    engine_to_world(state);
-    
-    fclose(fptr);
+    // Build the game world straight from the level
+    load_level(state, filename);
 }
 
 // Handle player input
 void handleInput(GameState *state, Player *user, int *gameRunning) {
-    char ch = getch();
-    
-    // Store original position for collision checking
-    int newY = playerPosY;
-    int newX = playerPosX;
-    
-    // Move current character
-    world[playerPosY][playerPosX] = '.';
-    
-    // Process input
-    switch(ch) {
-        case 'w': newY--; break;
-        case 'a': newX--; break;
-        case 's': newY++; break;
-        case 'd': newX++; break;
-        case 'q': *gameRunning = 0; break;
-        case 'z': 
-            save_game(state, "savegame.sav");
-            break;
-        case 'x':
-            if (load_game(state, "savegame.sav")) {
-                world_to_engine(state);
-                playerPosX = state->player.x;
-                playerPosY = state->player.y;
-                user->health = state->player.health;
-                user->max_health = state->player.max_health;
-            }
-            break;
-        case 'i': // Inventory
-            // Show inventory screen (would be implemented in a full game)
-            break;
-        case 'c': // Character sheet
-            // Show character screen (would be implemented in a full game)
-            break;
-        case 'm': // Map
-            // Show map screen (would be implemented in a full game)
-            break;
-        default: break;
+    PhaseTimings timings = {0};
+    int key = platform_getch();
+    if (key == PLATFORM_KEY_EOF) {
+        *gameRunning = 0;
+        return;
     }
-    
-    // Check if move is valid
-    if (newY >= 0 && newY < HEIGHT && newX >= 0 && newX < WIDTH && 
-        collisionMap[newY][newX] != 1 && ch != 'q' && ch != 'z' && ch != 'x' && 
-        ch != 'i' && ch != 'c' && ch != 'm') {
-        
-        // Check for enemy at new position
-        int enemyEncountered = 0;
-        for (int i = 0; i < enemyCount; i++) {
-            if (enemyList[i]->y == newY && enemyList[i]->x == newX) {
-                // Combat logic would go here
-                enemyEncountered = 1;
-                break;
-            }
-        }
-        
-        if (!enemyEncountered) {
-            playerPosY = newY;
-            playerPosX = newX;
-            
-            // Update game state
-            state->player.x = playerPosX;
-            state->player.y = playerPosY;
-        }
-    }
-    
-    // Update world with new player position
-    world[playerPosY][playerPosX] = '@';
-}
\ No newline at end of file
+    processKey(state, user, (char)key, gameRunning, &timings);
+}
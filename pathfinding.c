@@ -0,0 +1,306 @@
+#include "pathfinding.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Movement costs (scaled by 10 so diagonals stay integral)
+#define PATH_COST_STRAIGHT 10
+#define PATH_COST_DIAGONAL 14
+
+// Neighbour offsets: first four are orthogonal, last four diagonal
+static const int path_dirs[8][2] = {
+    {0, -1}, {1, 0}, {0, 1}, {-1, 0},
+    {1, -1}, {1, 1}, {-1, 1}, {-1, -1}
+};
+
+/**
+ * Estimate remaining cost between two points
+ */
+static int path_estimate(PathHeuristic heuristic, int x1, int y1, int x2, int y2) {
+    int dx = abs(x2 - x1);
+    int dy = abs(y2 - y1);
+
+    if (heuristic == PATH_OCTILE) {
+        int diag = dx < dy ? dx : dy;
+        return PATH_COST_STRAIGHT * (dx + dy) + (PATH_COST_DIAGONAL - 2 * PATH_COST_STRAIGHT) * diag;
+    }
+
+    return PATH_COST_STRAIGHT * (dx + dy);
+}
+
+/**
+ * Get the search buffers held in a slot, (re)allocating them for a window size
+ */
+static PathBuffers* get_path_buffers(PathBuffers** slot, int width, int height) {
+    PathBuffers* buffers = *slot;
+    if (buffers && buffers->width == width && buffers->height == height)
+        return buffers;
+
+    free_path_buffers(buffers);
+    *slot = NULL;
+
+    int nodes = width * height;
+    int words = (nodes + 31) / 32;
+
+    buffers = (PathBuffers*)calloc(1, sizeof(PathBuffers));
+    if (!buffers) return NULL;
+
+    buffers->width = width;
+    buffers->height = height;
+    buffers->stamp = (unsigned int*)calloc(nodes, sizeof(unsigned int));
+    buffers->g_score = (int*)malloc(nodes * sizeof(int));
+    buffers->f_score = (int*)malloc(nodes * sizeof(int));
+    buffers->parent = (int*)malloc(nodes * sizeof(int));
+    buffers->heap = (int*)malloc(nodes * sizeof(int));
+    buffers->heap_pos = (int*)malloc(nodes * sizeof(int));
+    buffers->closed = (unsigned int*)malloc(words * sizeof(unsigned int));
+
+    if (!buffers->stamp || !buffers->g_score || !buffers->f_score || !buffers->parent ||
+        !buffers->heap || !buffers->heap_pos || !buffers->closed) {
+        free_path_buffers(buffers);
+        return NULL;
+    }
+
+    *slot = buffers;
+    return buffers;
+}
+
+/**
+ * Free search buffers
+ */
+void free_path_buffers(PathBuffers* buffers) {
+    if (!buffers) return;
+
+    free(buffers->stamp);
+    free(buffers->g_score);
+    free(buffers->f_score);
+    free(buffers->parent);
+    free(buffers->heap);
+    free(buffers->heap_pos);
+    free(buffers->closed);
+    free(buffers);
+}
+
+// Binary heap helpers
+
+static void heap_swap(PathBuffers* b, int i, int j) {
+    int a = b->heap[i];
+    int c = b->heap[j];
+    b->heap[i] = c;
+    b->heap[j] = a;
+    b->heap_pos[c] = i;
+    b->heap_pos[a] = j;
+}
+
+static void heap_sift_up(PathBuffers* b, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (b->f_score[b->heap[parent]] <= b->f_score[b->heap[i]]) break;
+        heap_swap(b, i, parent);
+        i = parent;
+    }
+}
+
+static void heap_sift_down(PathBuffers* b, int i) {
+    for (;;) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
+
+        if (left < b->heap_size && b->f_score[b->heap[left]] < b->f_score[b->heap[smallest]])
+            smallest = left;
+        if (right < b->heap_size && b->f_score[b->heap[right]] < b->f_score[b->heap[smallest]])
+            smallest = right;
+        if (smallest == i) break;
+
+        heap_swap(b, i, smallest);
+        i = smallest;
+    }
+}
+
+static void heap_push(PathBuffers* b, int node) {
+    b->heap[b->heap_size] = node;
+    b->heap_pos[node] = b->heap_size;
+    b->heap_size++;
+    heap_sift_up(b, b->heap_size - 1);
+}
+
+static int heap_pop(PathBuffers* b) {
+    int node = b->heap[0];
+    b->heap_size--;
+    b->heap_pos[node] = -1;
+
+    if (b->heap_size > 0) {
+        b->heap[0] = b->heap[b->heap_size];
+        b->heap_pos[b->heap[0]] = 0;
+        heap_sift_down(b, 0);
+    }
+
+    return node;
+}
+
+/**
+ * Check if a node inside the search window can be entered
+ */
+static int path_node_walkable(const ChunkWindow* window, int x, int y) {
+    if (x < 0 || y < 0 || x >= window->width || y >= window->height)
+        return 0;
+
+    return window_walkable(window, x, y);
+}
+
+/**
+ * Find a path between two world positions using A*
+ * The search covers the 3x3 chunks around the start, so paths cross chunk
+ * edges. Writes up to max_length steps (excluding the start, in world
+ * coordinates) into out_path and returns the number written. If the target
+ * can't be reached within the window or PATH_MAX_EXPANSIONS, the path leads
+ * to the closest node found instead.
+ */
+int find_path(GameState* state, int start_x, int start_y,
+              int target_x, int target_y, PathHeuristic heuristic,
+              int (*out_path)[2], int max_length) {
+    if (!state) return 0;
+
+    int local_x, local_y;
+    WorldChunk* home = get_chunk_for_world(state, start_x, start_y, &local_x, &local_y);
+    if (!home) return 0;
+
+    ChunkWindow window;
+    get_chunk_window(state, home->x, home->y, &window);
+
+    return find_path_in_window(&window, &home->path_buffers, start_x, start_y,
+                               target_x, target_y, heuristic, out_path, max_length);
+}
+
+/**
+ * find_path over a window the caller collected, with the caller's buffers
+ * *buffers is allocated or resized as needed. Nothing else is written, so
+ * threads with their own buffers can search the same window at once.
+ */
+int find_path_in_window(const ChunkWindow* window, PathBuffers** buffers,
+                        int start_x, int start_y, int target_x, int target_y,
+                        PathHeuristic heuristic, int (*out_path)[2], int max_length) {
+    if (!window || !buffers || !out_path || max_length <= 0) return 0;
+    if (start_x == target_x && start_y == target_y) return 0;
+
+    int width = window->width;
+    int height = window->height;
+
+    // Switch to window-local coordinates
+    start_x -= window->origin_x;
+    start_y -= window->origin_y;
+    target_x -= window->origin_x;
+    target_y -= window->origin_y;
+    if (start_x < 0 || start_y < 0 || start_x >= width || start_y >= height) return 0;
+
+    int target = -1;
+    if (target_x >= 0 && target_y >= 0 && target_x < width && target_y < height) {
+        if (!path_node_walkable(window, target_x, target_y)) return 0;
+        target = target_y * width + target_x;
+    }
+
+    PathBuffers* b = get_path_buffers(buffers, width, height);
+    if (!b) return 0;
+
+    // New search id invalidates all scores from previous searches without clearing
+    b->search_id++;
+    if (b->search_id == 0) {
+        memset(b->stamp, 0, width * height * sizeof(unsigned int));
+        b->search_id = 1;
+    }
+    memset(b->closed, 0, ((width * height + 31) / 32) * sizeof(unsigned int));
+    b->heap_size = 0;
+
+    int dir_count = heuristic == PATH_OCTILE ? 8 : 4;
+    int start = start_y * width + start_x;
+
+    b->stamp[start] = b->search_id;
+    b->g_score[start] = 0;
+    b->f_score[start] = path_estimate(heuristic, start_x, start_y, target_x, target_y);
+    b->parent[start] = -1;
+    heap_push(b, start);
+
+    int best = start;
+    int best_h = b->f_score[start];
+    int expansions = 0;
+    int found = 0;
+
+    while (b->heap_size > 0 && expansions < PATH_MAX_EXPANSIONS) {
+        int current = heap_pop(b);
+        if (current == target) {
+            found = 1;
+            break;
+        }
+
+        b->closed[current >> 5] |= 1u << (current & 31);
+        expansions++;
+
+        int cx = current % width;
+        int cy = current / width;
+
+        int h = b->f_score[current] - b->g_score[current];
+        if (h < best_h) {
+            best_h = h;
+            best = current;
+        }
+
+        for (int d = 0; d < dir_count; d++) {
+            int nx = cx + path_dirs[d][0];
+            int ny = cy + path_dirs[d][1];
+
+            if (!path_node_walkable(window, nx, ny)) continue;
+
+            int cost = PATH_COST_STRAIGHT;
+            if (d >= 4) {
+                // Don't cut corners around walls
+                if (!path_node_walkable(window, nx, cy) || !path_node_walkable(window, cx, ny))
+                    continue;
+                cost = PATH_COST_DIAGONAL;
+            }
+
+            int neighbor = ny * width + nx;
+            if (b->closed[neighbor >> 5] & (1u << (neighbor & 31))) continue;
+
+            int tentative = b->g_score[current] + cost;
+
+            if (b->stamp[neighbor] != b->search_id) {
+                // First time this search sees the node
+                b->stamp[neighbor] = b->search_id;
+                b->g_score[neighbor] = tentative;
+                b->f_score[neighbor] = tentative + path_estimate(heuristic, nx, ny, target_x, target_y);
+                b->parent[neighbor] = current;
+                heap_push(b, neighbor);
+            } else if (tentative < b->g_score[neighbor]) {
+                // Found a cheaper route to a queued node
+                b->f_score[neighbor] -= b->g_score[neighbor] - tentative;
+                b->g_score[neighbor] = tentative;
+                b->parent[neighbor] = current;
+                heap_sift_up(b, b->heap_pos[neighbor]);
+            }
+        }
+    }
+
+    int end = found ? target : best;
+    if (end == start) return 0;
+
+    // Count steps back to the start
+    int length = 0;
+    for (int node = end; node != start; node = b->parent[node]) {
+        length++;
+    }
+
+    // Skip the tail that doesn't fit so the path keeps its first steps
+    int node = end;
+    for (int i = length; i > max_length; i--) {
+        node = b->parent[node];
+    }
+
+    int written = length < max_length ? length : max_length;
+    for (int i = written - 1; i >= 0; i--) {
+        out_path[i][0] = node % width + window->origin_x;
+        out_path[i][1] = node / width + window->origin_y;
+        node = b->parent[node];
+    }
+
+    return written;
+}
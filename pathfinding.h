@@ -0,0 +1,38 @@
+#ifndef PATHFINDING_H
+#define PATHFINDING_H
+
+#include "gamestate.h"
+
+// Upper bound on nodes expanded by a single search so AI cost per turn stays bounded
+#define PATH_MAX_EXPANSIONS 2048
+
+// Heuristic (and matching neighbourhood) used by the A* search
+typedef enum {
+    PATH_MANHATTAN = 0,     // 4-way movement, Manhattan distance
+    PATH_OCTILE = 1         // 8-way movement, octile distance
+} PathHeuristic;
+
+// Reusable search buffers, allocated once per chunk (or per thread) on first use
+typedef struct PathBuffers {
+    int width, height;          // Dimensions of the search window the buffers cover
+    unsigned int search_id;     // Incremented per search to invalidate old scores
+    unsigned int* stamp;        // Search id that last touched each node
+    int* g_score;               // Cost from start to each node
+    int* f_score;               // g + heuristic for each node
+    int* parent;                // Node we came from (-1 for start)
+    int* heap;                  // Binary min-heap of node indices ordered by f_score
+    int* heap_pos;              // Position of each node in the heap (-1 if not queued)
+    int heap_size;              // Number of nodes currently in the heap
+    unsigned int* closed;       // Closed-set bitmap, one bit per node
+} PathBuffers;
+
+// Search API
+int find_path(GameState* state, int start_x, int start_y,
+              int target_x, int target_y, PathHeuristic heuristic,
+              int (*out_path)[2], int max_length);
+int find_path_in_window(const ChunkWindow* window, PathBuffers** buffers,
+                        int start_x, int start_y, int target_x, int target_y,
+                        PathHeuristic heuristic, int (*out_path)[2], int max_length);
+void free_path_buffers(PathBuffers* buffers);
+
+#endif /* PATHFINDING_H */
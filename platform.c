@@ -0,0 +1,213 @@
+#include "platform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <conio.h>
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// Windows console backend
+
+/**
+ * Enable ANSI colours for the console
+ */
+void platform_init_terminal(void) {
+    system("setup.bat");
+}
+
+void platform_restore_terminal(void) {
+}
+
+void platform_clear_screen(void) {
+    system("cls");
+}
+
+void platform_cursor_home(void) {
+    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    COORD position = {0, 0};
+    SetConsoleCursorPosition(hOut, position);
+}
+
+int platform_kbhit(void) {
+    return _kbhit();
+}
+
+int platform_getch(void) {
+    return _getch();
+}
+
+/**
+ * Wait for a key press without spinning
+ * Returns the key, or -1 once timeout_ms passes (a negative timeout waits forever).
+ */
+int platform_wait_key(int timeout_ms) {
+    HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+    DWORD start = GetTickCount();
+
+    for (;;) {
+        if (_kbhit()) return _getch();
+
+        DWORD wait = INFINITE;
+        if (timeout_ms >= 0) {
+            DWORD elapsed = GetTickCount() - start;
+            if (elapsed >= (DWORD)timeout_ms) return -1;
+            wait = (DWORD)timeout_ms - elapsed;
+        }
+
+        // Signalled by any console event; _kbhit discards the non-key ones
+        if (WaitForSingleObject(input, wait) != WAIT_OBJECT_0) return -1;
+    }
+}
+
+/**
+ * Milliseconds from a monotonic clock
+ */
+double platform_time_ms(void) {
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+}
+
+/**
+ * Number of processors available to run threads (at least 1)
+ */
+int platform_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+// POSIX terminal backend
+
+static struct termios saved_termios;
+static int raw_mode = 0;
+
+/**
+ * Put the terminal back the way we found it, then die from the signal
+ * Only async-signal-safe calls here: no stdio.
+ */
+static void restore_on_signal(int sig) {
+    static const char reset[] = "\033[0m\033[?25h";
+
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+    if (write(STDOUT_FILENO, reset, sizeof(reset) - 1) < 0) {
+        // Nothing more to do; the process is going down anyway
+    }
+
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/**
+ * Switch the terminal to unbuffered, no-echo input
+ * Output processing and signals stay on, so printf and Ctrl-C behave.
+ */
+void platform_init_terminal(void) {
+    if (raw_mode || !isatty(STDIN_FILENO)) return;
+    if (tcgetattr(STDIN_FILENO, &saved_termios) != 0) return;
+
+    struct termios raw = saved_termios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) return;
+
+    raw_mode = 1;
+    atexit(platform_restore_terminal);
+    signal(SIGINT, restore_on_signal);
+    signal(SIGTERM, restore_on_signal);
+
+    // Hide the cursor while the game owns the screen
+    fputs("\033[?25l", stdout);
+    fflush(stdout);
+}
+
+void platform_restore_terminal(void) {
+    if (!raw_mode) return;
+
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+    raw_mode = 0;
+
+    fputs("\033[0m\033[?25h", stdout);
+    fflush(stdout);
+}
+
+void platform_clear_screen(void) {
+    fputs("\033[2J\033[H", stdout);
+    fflush(stdout);
+}
+
+void platform_cursor_home(void) {
+    fputs("\033[H", stdout);
+    fflush(stdout);
+}
+
+int platform_kbhit(void) {
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    return poll(&fd, 1, 0) > 0;
+}
+
+/**
+ * Read one key
+ * Returns the key, -1 if interrupted, or PLATFORM_KEY_EOF once input is closed.
+ */
+int platform_getch(void) {
+    fflush(stdout);
+
+    unsigned char c;
+    ssize_t count = read(STDIN_FILENO, &c, 1);
+    if (count == 1) return c;
+    if (count < 0 && (errno == EINTR || errno == EAGAIN)) return -1;
+    return PLATFORM_KEY_EOF;
+}
+
+/**
+ * Wait for a key press without spinning
+ * Returns the key, -1 once timeout_ms passes (a negative timeout waits
+ * forever), or PLATFORM_KEY_EOF once input is closed.
+ */
+int platform_wait_key(int timeout_ms) {
+    fflush(stdout);
+
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    int ready = poll(&fd, 1, timeout_ms < 0 ? -1 : timeout_ms);
+    if (ready <= 0) return -1;
+
+    // A hung-up or broken input stays ready forever; report it instead of spinning
+    if (!(fd.revents & POLLIN) && (fd.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+        return PLATFORM_KEY_EOF;
+    }
+
+    return platform_getch();
+}
+
+/**
+ * Milliseconds from a monotonic clock
+ */
+double platform_time_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * Number of processors available to run threads (at least 1)
+ */
+int platform_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+#endif
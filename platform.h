@@ -0,0 +1,23 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Terminal setup
+void platform_init_terminal(void);
+void platform_restore_terminal(void);
+void platform_clear_screen(void);
+void platform_cursor_home(void);
+
+// Keyboard input
+#define PLATFORM_KEY_EOF (-2)   // Returned once stdin is closed; treat as quit
+
+int platform_kbhit(void);
+int platform_getch(void);
+int platform_wait_key(int timeout_ms);
+
+// Timing
+double platform_time_ms(void);
+
+// Processors
+int platform_cpu_count(void);
+
+#endif /* PLATFORM_H */
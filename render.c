@@ -0,0 +1,200 @@
+#include "render.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>      // For _write
+#else
+#include <unistd.h>
+#endif
+
+// Worst case output for one frame: every cell with a cursor move and colour change
+#define RENDER_OUTPUT_SIZE (RENDER_ROWS * RENDER_COLS * 24 + 64)
+
+// Front buffer is what the terminal shows; back buffer is the frame being built
+static RenderCell front[RENDER_ROWS][RENDER_COLS];
+static RenderCell back[RENDER_ROWS][RENDER_COLS];
+static int front_valid = 0;     // Whether front matches the terminal
+static int back_rows = 0;       // Rows touched in the frame being built
+
+// Output assembled so a frame normally goes out in a single write
+static char output[RENDER_OUTPUT_SIZE];
+static size_t output_size = 0;
+static size_t frame_bytes = 0;      // Bytes written so far in the current frame
+static size_t last_frame_bytes = 0;
+
+static const RenderCell blank_cell = {' ', COLOR_FG_DEFAULT, COLOR_BG_BLACK};
+
+/**
+ * Write the pending output to the terminal
+ * A failed write leaves the screen unknown, so the next frame redraws it.
+ */
+static void write_output(void) {
+    // Anything printed through stdio has to land first
+    fflush(stdout);
+
+    size_t done = 0;
+    while (done < output_size) {
+#ifdef _WIN32
+        int written = _write(1, output + done, (unsigned int)(output_size - done));
+#else
+        ssize_t written = write(STDOUT_FILENO, output + done, output_size - done);
+#endif
+        if (written <= 0) {
+            front_valid = 0;
+            break;
+        }
+        done += (size_t)written;
+    }
+
+    frame_bytes += output_size;
+    output_size = 0;
+}
+
+static void out_bytes(const char* data, size_t size) {
+    // A frame larger than the buffer goes out in several writes
+    if (output_size + size > sizeof(output)) write_output();
+    memcpy(output + output_size, data, size);
+    output_size += size;
+}
+
+static void out_format(const char* format, ...) {
+    char text[64];
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    if (written <= 0) return;
+    if ((size_t)written >= sizeof(text)) written = (int)sizeof(text) - 1;
+    out_bytes(text, (size_t)written);
+}
+
+/**
+ * Finish the frame: write what is left and record its size
+ */
+static void flush_output(void) {
+    write_output();
+    last_frame_bytes = frame_bytes;
+    frame_bytes = 0;
+}
+
+/**
+ * Start a new frame with a blank back buffer
+ */
+void render_begin(void) {
+    for (int row = 0; row < RENDER_ROWS; row++) {
+        for (int col = 0; col < RENDER_COLS; col++) {
+            back[row][col] = blank_cell;
+        }
+    }
+    back_rows = 0;
+}
+
+/**
+ * Set one cell of the frame being built
+ */
+void render_put(int row, int col, char ch, int fg, int bg) {
+    if (row < 0 || col < 0 || row >= RENDER_ROWS || col >= RENDER_COLS) return;
+
+    RenderCell* cell = &back[row][col];
+    cell->ch = ch;
+    cell->fg = (unsigned char)fg;
+    cell->bg = (unsigned char)bg;
+
+    if (row + 1 > back_rows) back_rows = row + 1;
+}
+
+/**
+ * Write formatted text into the frame, clipped to the row
+ * Returns the number of columns written.
+ */
+int render_text(int row, int col, int fg, int bg, const char* format, ...) {
+    char text[RENDER_COLS + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    int written = 0;
+    for (const char* c = text; *c && col + written < RENDER_COLS; c++) {
+        render_put(row, col + written, *c, fg, bg);
+        written++;
+    }
+
+    // Empty lines still count toward the frame's height
+    if (row + 1 > back_rows && row >= 0 && row < RENDER_ROWS) back_rows = row + 1;
+    return written;
+}
+
+/**
+ * Send the cells that changed since the last frame to the terminal
+ * Moves the cursor only between runs of changed cells and changes colour
+ * only when it differs from the previous cell written. The cursor is left
+ * below the frame so regular printf output still follows it.
+ */
+void render_present(void) {
+    int cursor_row = -1;
+    int cursor_col = -1;
+    int current_fg = -1;
+    int current_bg = -1;
+
+    // Unknown screen contents: clear once and diff against blank
+    if (!front_valid) {
+        out_format("\033[0m\033[2J");
+        for (int row = 0; row < RENDER_ROWS; row++) {
+            for (int col = 0; col < RENDER_COLS; col++) {
+                front[row][col] = blank_cell;
+            }
+        }
+        front_valid = 1;
+    }
+
+    for (int row = 0; row < RENDER_ROWS; row++) {
+        for (int col = 0; col < RENDER_COLS; col++) {
+            RenderCell* want = &back[row][col];
+            RenderCell* have = &front[row][col];
+            if (want->ch == have->ch && want->fg == have->fg && want->bg == have->bg)
+                continue;
+
+            if (cursor_row != row || cursor_col != col) {
+                out_format("\033[%d;%dH", row + 1, col + 1);
+            }
+
+            if (want->fg != current_fg && want->bg != current_bg) {
+                out_format("\033[%d;%dm", want->fg, want->bg);
+            } else if (want->fg != current_fg) {
+                out_format("\033[%dm", want->fg);
+            } else if (want->bg != current_bg) {
+                out_format("\033[%dm", want->bg);
+            }
+            current_fg = want->fg;
+            current_bg = want->bg;
+
+            out_bytes(&want->ch, 1);
+            *have = *want;
+            cursor_row = row;
+            cursor_col = col + 1;
+        }
+    }
+
+    // Park the cursor under the frame with default colours and clear what
+    // regular printf output left below it last time
+    out_format("\033[%d;1H\033[0m\033[J", back_rows + 1);
+
+    flush_output();
+}
+
+/**
+ * Forget what the terminal shows so the next frame repaints everything
+ */
+void render_invalidate(void) {
+    front_valid = 0;
+}
+
+/**
+ * Bytes sent to the terminal by the last frame
+ */
+size_t render_last_frame_bytes(void) {
+    return last_frame_bytes;
+}
@@ -0,0 +1,38 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stddef.h>
+
+// Size of the character grid the renderer manages
+#define RENDER_ROWS 48
+#define RENDER_COLS 80
+
+// ANSI SGR colour codes used by the game
+#define COLOR_FG_DEFAULT   37
+#define COLOR_FG_GREY      90
+#define COLOR_FG_YELLOW    33
+#define COLOR_FG_BRIGHT_GREEN  92
+#define COLOR_FG_BRIGHT_YELLOW 93
+#define COLOR_FG_BRIGHT_CYAN   96
+#define COLOR_BG_BLACK     40
+#define COLOR_BG_WHITE     47
+#define COLOR_BG_GREY      100
+
+// One terminal column: glyph plus colours
+typedef struct RenderCell {
+    char ch;                // Character shown
+    unsigned char fg;       // Foreground SGR code
+    unsigned char bg;       // Background SGR code
+} RenderCell;
+
+// Frame building
+void render_begin(void);
+void render_put(int row, int col, char ch, int fg, int bg);
+int render_text(int row, int col, int fg, int bg, const char* format, ...);
+
+// Output
+void render_present(void);
+void render_invalidate(void);
+size_t render_last_frame_bytes(void);
+
+#endif /* RENDER_H */
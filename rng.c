@@ -0,0 +1,89 @@
+#include "rng.h"
+
+/**
+ * One splitmix64 step: advances the state and returns a well-mixed value
+ */
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Seed a generator from a single 64-bit value
+ */
+void rng_seed(Rng* rng, uint64_t seed) {
+    uint64_t state = seed;
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&state);
+    }
+}
+
+/**
+ * Hash a seed, domain and two keys into one 64-bit value
+ * Usable on its own where a single number per key is enough (terrain)
+ */
+uint64_t rng_hash(uint64_t seed, uint32_t domain, int64_t key_a, int64_t key_b) {
+    uint64_t state = seed ^ ((uint64_t)domain << 32);
+    uint64_t h = splitmix64(&state);
+    state = h ^ (uint64_t)key_a;
+    h = splitmix64(&state);
+    state = h ^ (uint64_t)key_b;
+    return splitmix64(&state);
+}
+
+/**
+ * Start an independent stream for (seed, domain, key_a, key_b)
+ */
+void rng_stream(Rng* rng, uint64_t seed, uint32_t domain, int64_t key_a, int64_t key_b) {
+    rng_seed(rng, rng_hash(seed, domain, key_a, key_b));
+}
+
+/**
+ * Next 64 random bits
+ */
+uint64_t rng_next(Rng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    
+    return result;
+}
+
+/**
+ * Uniform value in [0, n) without modulo bias
+ */
+uint32_t rng_range(Rng* rng, uint32_t n) {
+    if (n == 0) return 0;
+    
+    // Multiply-shift, rejecting the few low products that would bias the result
+    uint64_t m = (rng_next(rng) >> 32) * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t threshold = (uint32_t)(-n) % n;
+        while (low < threshold) {
+            m = (rng_next(rng) >> 32) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/**
+ * Uniform float in [0, 1)
+ */
+float rng_float(Rng* rng) {
+    return (rng_next(rng) >> 40) * (1.0f / 16777216.0f);
+}
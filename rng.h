@@ -0,0 +1,36 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/*
+ * Seeded random numbers (xoshiro256** seeded through splitmix64).
+ *
+ * Every consumer draws from its own stream, derived from the world seed, a
+ * domain and up to two keys (e.g. entity id and turn). Streams never share
+ * state, so results don't depend on the order chunks are generated or
+ * entities are processed, and workers can draw without locking. Nothing
+ * needs saving: the same seed, keys and turn give the same numbers again.
+ */
+
+// Stream domains
+#define RNG_DOMAIN_CHUNK        1   // Terrain generation, keyed by world tile position
+#define RNG_DOMAIN_ENEMY        2   // Enemy AI, keyed by enemy id and turn
+#define RNG_DOMAIN_ENGINE_ENEMY 3   // Level enemies, keyed by list index and turn
+#define RNG_DOMAIN_INPUT        4   // Headless random moves
+
+typedef struct Rng {
+    uint64_t s[4];          // xoshiro256** state
+} Rng;
+
+// Streams
+void rng_seed(Rng* rng, uint64_t seed);
+void rng_stream(Rng* rng, uint64_t seed, uint32_t domain, int64_t key_a, int64_t key_b);
+uint64_t rng_hash(uint64_t seed, uint32_t domain, int64_t key_a, int64_t key_b);
+
+// Drawing
+uint64_t rng_next(Rng* rng);
+uint32_t rng_range(Rng* rng, uint32_t n);
+float rng_float(Rng* rng);
+
+#endif /* RNG_H */
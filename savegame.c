@@ -0,0 +1,1690 @@
+#include "savegame.h"
+#include "chunkpack.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>      // For _commit
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Fixed record sizes in the binary format
+#define SAVE_PLAYER_SIZE        (6 * 4 + 32)
+#define SAVE_WORLD_SIZE         (64 + 8 * 4 + 8)
+#define SAVE_CHUNK_HEADER_SIZE  (5 * 4 + 8)
+#define SAVE_ENEMY_SIZE         (8 * 4 + 4)
+#define SAVE_ITEM_SIZE          (32 + 4 + 4 + 8 + 4 + 10 * 4)
+#define SAVE_ITEM_STORE_SIZE    (4 * 4 + SAVE_ITEM_SIZE)
+#define SAVE_DIR_ENTRY_SIZE     (6 * 4 + 8 + 8)
+
+// How a chunk's tiles are stored (directory entries and section tags)
+#define SAVE_CHUNK_RAW          0
+#define SAVE_CHUNK_PACKED       1
+
+// Sanity limit on chunk dimensions read from disk
+#define SAVE_MAX_CHUNK_TILES    (1 << 24)
+
+// Growable byte buffer used to build section payloads
+typedef struct SaveBuffer {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    int failed;             // A write was dropped because the buffer couldn't grow
+} SaveBuffer;
+
+// Cursor over a section payload being decoded
+typedef struct SaveReader {
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+    int swap;       // Payload was written with the other byte order
+    int error;      // Set when a read runs past the end
+} SaveReader;
+
+// A chunk's tiles in the form they will be written
+typedef struct ChunkPayload {
+    const void* data;       // Raw WorldTiles or a packed block
+    size_t size;            // Bytes at data
+    int encoding;           // SAVE_CHUNK_RAW or SAVE_CHUNK_PACKED
+    unsigned char* scratch; // Packed block allocated just for this write
+} ChunkPayload;
+
+// A save file mapped (or read) into memory
+struct SaveMapping {
+    const unsigned char* data;  // File contents
+    size_t size;                // File size in bytes
+    int swap;                   // File was written with the other byte order
+    int owned;                  // data is a heap copy rather than a mapping
+#ifdef _WIN32
+    HANDLE file_handle;
+    HANDLE map_handle;
+#endif
+};
+
+// A save running on a worker thread against a snapshot of the game
+struct SaveJob {
+    pthread_t thread;
+    GameState* snapshot;    // Private copy the worker serializes
+    char filename[256];     // Target save file
+    int incremental;        // Append to the journal instead of a full save
+    int result;             // Worker's return value, valid once done is set
+    atomic_int done;        // Set by the worker when it has finished
+};
+
+// Writing helpers
+
+static void buffer_put(SaveBuffer* buf, const void* data, size_t size) {
+    if (buf->size + size > buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity : 256;
+        while (capacity < buf->size + size) capacity *= 2;
+        
+        unsigned char* grown = (unsigned char*)realloc(buf->data, capacity);
+        if (!grown) {
+            buf->failed = 1;
+            return;
+        }
+        buf->data = grown;
+        buf->capacity = capacity;
+    }
+    
+    memcpy(buf->data + buf->size, data, size);
+    buf->size += size;
+}
+
+static void put_i32(SaveBuffer* buf, int32_t value) {
+    buffer_put(buf, &value, sizeof(value));
+}
+
+static void put_i64(SaveBuffer* buf, int64_t value) {
+    buffer_put(buf, &value, sizeof(value));
+}
+
+static void put_f64(SaveBuffer* buf, double value) {
+    buffer_put(buf, &value, sizeof(value));
+}
+
+static void put_bytes(SaveBuffer* buf, const void* data, size_t size) {
+    buffer_put(buf, data, size);
+}
+
+static void put_char(SaveBuffer* buf, char value) {
+    // Padded to keep the following fields 4-byte aligned
+    unsigned char bytes[4] = {(unsigned char)value, 0, 0, 0};
+    buffer_put(buf, bytes, sizeof(bytes));
+}
+
+/**
+ * Write a section header
+ */
+static int write_section_header(FILE* file, const char* tag, uint32_t length) {
+    return fwrite(tag, 1, 4, file) == 4 &&
+           fwrite(&length, sizeof(length), 1, file) == 1;
+}
+
+/**
+ * Write a complete section from a buffer
+ * Fails if any write into the buffer was dropped.
+ */
+static int write_section(FILE* file, const char* tag, const SaveBuffer* buf) {
+    if (buf->failed || !write_section_header(file, tag, (uint32_t)buf->size)) return 0;
+    
+    return buf->size == 0 || fwrite(buf->data, 1, buf->size, file) == buf->size;
+}
+
+/**
+ * Flush a file through to the disk
+ */
+static int sync_file(FILE* file) {
+    if (fflush(file) != 0) return 0;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Reading helpers
+
+static void swap_bytes(void* data, size_t size) {
+    unsigned char* bytes = (unsigned char*)data;
+    for (size_t i = 0; i < size / 2; i++) {
+        unsigned char tmp = bytes[i];
+        bytes[i] = bytes[size - 1 - i];
+        bytes[size - 1 - i] = tmp;
+    }
+}
+
+static void get_raw(SaveReader* r, void* out, size_t size) {
+    if (r->pos + size > r->size) {
+        r->error = 1;
+        memset(out, 0, size);
+        return;
+    }
+    
+    memcpy(out, r->data + r->pos, size);
+    r->pos += size;
+}
+
+static int32_t get_i32(SaveReader* r) {
+    int32_t value;
+    get_raw(r, &value, sizeof(value));
+    if (r->swap) swap_bytes(&value, sizeof(value));
+    return value;
+}
+
+static int64_t get_i64(SaveReader* r) {
+    int64_t value;
+    get_raw(r, &value, sizeof(value));
+    if (r->swap) swap_bytes(&value, sizeof(value));
+    return value;
+}
+
+static double get_f64(SaveReader* r) {
+    double value;
+    get_raw(r, &value, sizeof(value));
+    if (r->swap) swap_bytes(&value, sizeof(value));
+    return value;
+}
+
+static char get_char(SaveReader* r) {
+    unsigned char bytes[4];
+    get_raw(r, bytes, sizeof(bytes));
+    return (char)bytes[0];
+}
+
+/**
+ * Fix the byte order of tiles read from a save with the other endianness
+ */
+static void swap_tiles(WorldTile* tiles, int count) {
+    for (int i = 0; i < count; i++) {
+        swap_bytes(&tiles[i].entity_id, sizeof(tiles[i].entity_id));
+        swap_bytes(&tiles[i].item_id, sizeof(tiles[i].item_id));
+    }
+}
+
+// Save file mapping
+
+/**
+ * Map a save file into memory read-only
+ * Falls back to reading the file into a heap buffer where mapping fails.
+ */
+static SaveMapping* map_save_file(const char* filename) {
+    SaveMapping* mapping = (SaveMapping*)calloc(1, sizeof(SaveMapping));
+    if (!mapping) return NULL;
+    
+#ifdef _WIN32
+    mapping->file_handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mapping->file_handle != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(mapping->file_handle, &size) && size.QuadPart > 0) {
+            mapping->map_handle = CreateFileMappingA(mapping->file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping->map_handle) {
+                mapping->data = (const unsigned char*)MapViewOfFile(mapping->map_handle, FILE_MAP_READ, 0, 0, 0);
+                mapping->size = (size_t)size.QuadPart;
+            }
+        }
+        if (mapping->data) return mapping;
+        
+        if (mapping->map_handle) CloseHandle(mapping->map_handle);
+        CloseHandle(mapping->file_handle);
+        mapping->map_handle = NULL;
+        mapping->file_handle = NULL;
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                mapping->data = (const unsigned char*)data;
+                mapping->size = (size_t)info.st_size;
+            }
+        }
+        close(fd);
+        if (mapping->data) return mapping;
+    }
+#endif
+    
+    // Fallback: read the whole file
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        free(mapping);
+        return NULL;
+    }
+    
+    unsigned char* data = NULL;
+    size_t size = 0;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long length = ftell(file);
+        if (length > 0 && fseek(file, 0, SEEK_SET) == 0) {
+            data = (unsigned char*)malloc((size_t)length);
+            if (data && fread(data, 1, (size_t)length, file) == (size_t)length) {
+                size = (size_t)length;
+            }
+        }
+    }
+    fclose(file);
+    
+    if (size == 0) {
+        free(data);
+        free(mapping);
+        return NULL;
+    }
+    
+    mapping->data = data;
+    mapping->size = size;
+    mapping->owned = 1;
+    return mapping;
+}
+
+/**
+ * Unmap a save file
+ */
+void free_save_mapping(SaveMapping* mapping) {
+    if (!mapping) return;
+    
+    if (mapping->owned) {
+        free((void*)mapping->data);
+    } else {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping->data);
+        CloseHandle(mapping->map_handle);
+        CloseHandle(mapping->file_handle);
+#else
+        munmap((void*)mapping->data, mapping->size);
+#endif
+    }
+    
+    free(mapping);
+}
+
+/**
+ * Decode a dormant or lazily loaded chunk's tiles
+ */
+int materialize_chunk(World* world, WorldChunk* chunk) {
+    if (!world || !chunk) return 0;
+    if (chunk->tiles) return 1;
+    
+    int count = chunk->width * chunk->height;
+    
+    if (chunk->packed) {
+        // Packed blocks inside the save keep the file's byte order
+        int swap = !chunk->packed_owned && world->mapping && world->mapping->swap;
+        if (!unpack_chunk(chunk)) return 0;
+        if (swap) swap_tiles(chunk->tiles, count);
+        return 1;
+    }
+    
+    if (!chunk->mapped_tiles || !world->mapping) return 0;
+    
+    if (!alloc_chunk_tiles(chunk)) return 0;
+    
+    memcpy(chunk->tiles, chunk->mapped_tiles, (size_t)count * sizeof(WorldTile));
+    if (world->mapping->swap) swap_tiles(chunk->tiles, count);
+    
+    return 1;
+}
+
+/**
+ * Read one tile of a chunk without decoding the rest
+ * Returns 0 if the chunk has no tiles to read.
+ */
+int peek_chunk_tile(const World* world, const WorldChunk* chunk, int x, int y, WorldTile* out) {
+    if (!world || !chunk || !out) return 0;
+    
+    int index = y * chunk->width + x;
+    if (chunk->tiles) {
+        *out = chunk->tiles[index];
+        return 1;
+    }
+    
+    // Tiles still in the save keep the file's byte order
+    int swap = world->mapping && world->mapping->swap;
+    if (chunk->packed) {
+        if (!packed_tile_at(chunk->packed, chunk->packed_size, chunk->width * chunk->height, index, out))
+            return 0;
+        if (swap && !chunk->packed_owned) swap_tiles(out, 1);
+        return 1;
+    }
+    
+    if (!chunk->mapped_tiles || !world->mapping) return 0;
+    
+    memcpy(out, &chunk->mapped_tiles[index], sizeof(WorldTile));
+    if (swap) swap_tiles(out, 1);
+    return 1;
+}
+
+/**
+ * Drop a chunk's decoded tiles if they still match the mapped save
+ */
+void release_chunk_tiles(World* world, WorldChunk* chunk) {
+    if (!world || !chunk || !chunk->tiles || !chunk->mapped_tiles || chunk->dirty) return;
+    if (!world->mapping || world->mapping->swap) return;
+    
+    size_t bytes = (size_t)chunk->width * chunk->height * sizeof(WorldTile);
+    if (memcmp(chunk->tiles, chunk->mapped_tiles, bytes) != 0) return;
+    
+    free_chunk_tiles(chunk);
+}
+
+#ifdef _WIN32
+/**
+ * Decode every lazy chunk and release the save mapping
+ */
+static int detach_save_mapping(World* world) {
+    if (!world->mapping) return 1;
+    
+    for (int i = 0; i < world->chunk_count; i++) {
+        WorldChunk* chunk = world->chunks[i];
+        int in_mapping = chunk->packed ? !chunk->packed_owned : !chunk->tiles;
+        if (in_mapping && !materialize_chunk(world, chunk)) return 0;
+        chunk->mapped_tiles = NULL;
+    }
+    
+    free_save_mapping(world->mapping);
+    world->mapping = NULL;
+    return 1;
+}
+#endif
+
+// Binary writer
+
+/**
+ * Get a chunk's tiles in packed form for writing, without decoding it if possible
+ * Falls back to the raw tiles when the chunk has too many distinct tiles.
+ */
+static int encode_chunk(World* world, WorldChunk* chunk, ChunkPayload* out) {
+    memset(out, 0, sizeof(ChunkPayload));
+    int count = chunk->width * chunk->height;
+    int mapping_swapped = world->mapping && world->mapping->swap;
+    
+    // Dormant chunks are written as they are stored
+    if (!chunk->tiles && chunk->packed && (chunk->packed_owned || !mapping_swapped)) {
+        out->data = chunk->packed;
+        out->size = chunk->packed_size;
+        out->encoding = SAVE_CHUNK_PACKED;
+        return 1;
+    }
+    
+    // Unchanged lazy chunks are read straight from the mapping
+    const WorldTile* tiles = chunk->tiles;
+    if (!tiles && chunk->mapped_tiles && world->mapping && !mapping_swapped)
+        tiles = chunk->mapped_tiles;
+    if (!tiles && materialize_chunk(world, chunk))
+        tiles = chunk->tiles;
+    if (!tiles) return 0;
+    
+    out->size = pack_tiles(tiles, count, &out->scratch);
+    if (out->size > 0) {
+        out->data = out->scratch;
+        out->encoding = SAVE_CHUNK_PACKED;
+    } else {
+        out->data = tiles;
+        out->size = (size_t)count * sizeof(WorldTile);
+        out->encoding = SAVE_CHUNK_RAW;
+    }
+    
+    return 1;
+}
+
+/**
+ * Write the file header shared by saves and journals
+ */
+static int write_file_header(FILE* file, const char* magic) {
+    uint32_t version = SAVE_VERSION;
+    uint32_t mark = SAVE_ENDIAN_MARK;
+    
+    return fwrite(magic, 1, SAVE_MAGIC_SIZE, file) == SAVE_MAGIC_SIZE &&
+           fwrite(&version, sizeof(version), 1, file) == 1 &&
+           fwrite(&mark, sizeof(mark), 1, file) == 1;
+}
+
+static int write_player_section(FILE* file, GameState* state, SaveBuffer* buf) {
+    buf->size = 0;
+    put_i32(buf, state->player.x);
+    put_i32(buf, state->player.y);
+    put_i32(buf, state->player.health);
+    put_i32(buf, state->player.max_health);
+    put_i32(buf, state->player.strength);
+    put_i32(buf, state->player.level);
+    put_bytes(buf, state->player.name, sizeof(state->player.name));
+    return write_section(file, SAVE_TAG_PLAYER, buf);
+}
+
+/**
+ * Write one chunk: small header, then the tile block in a single write
+ */
+static int write_chunk_section(FILE* file, WorldChunk* chunk, const ChunkPayload* payload, SaveBuffer* buf) {
+    const char* tag = payload->encoding == SAVE_CHUNK_PACKED ? SAVE_TAG_CHUNK_PACKED : SAVE_TAG_CHUNK;
+    
+    buf->size = 0;
+    put_i32(buf, chunk->x);
+    put_i32(buf, chunk->y);
+    put_i32(buf, chunk->width);
+    put_i32(buf, chunk->height);
+    put_i32(buf, chunk->active);
+    put_i64(buf, (int64_t)chunk->last_updated);
+    if (buf->failed) return 0;
+    
+    return write_section_header(file, tag, (uint32_t)(buf->size + payload->size)) &&
+           fwrite(buf->data, 1, buf->size, file) == buf->size &&
+           fwrite(payload->data, 1, payload->size, file) == payload->size;
+}
+
+static int write_enemy_section(FILE* file, GameState* state, SaveBuffer* buf) {
+    buf->size = 0;
+    EnemyStore* enemies = &state->enemies;
+    put_i32(buf, enemies->count);
+    for (int i = 0; i < enemies->count; i++) {
+        put_i32(buf, enemies->id[i]);
+        put_i32(buf, enemies->x[i]);
+        put_i32(buf, enemies->y[i]);
+        put_i32(buf, enemies->health[i]);
+        put_i32(buf, enemies->faction_id[i]);
+        put_i32(buf, enemies->ai_state[i]);
+        put_i32(buf, enemies->detection_radius[i]);
+        put_i32(buf, enemies->behavior_flags[i]);
+        put_char(buf, enemies->icon[i]);
+    }
+    return write_section(file, SAVE_TAG_ENEMIES, buf);
+}
+
+static int write_item_section(FILE* file, GameState* state, SaveBuffer* buf) {
+    ItemStore* items = &state->items;
+    buf->size = 0;
+    put_i32(buf, items->count);
+    for (int slot = 0; slot < items->handles.slot_count; slot++) {
+        if (items->handles.slots[slot].value == SLOT_FREE) continue;
+        
+        ItemEntry* entry = &items->entries[slot];
+        GameItem* item = &entry->item;
+        put_i32(buf, item_store_handle(items, slot));
+        put_i32(buf, entry->x);
+        put_i32(buf, entry->y);
+        put_i32(buf, entry->below);
+        put_bytes(buf, item->name, sizeof(item->name));
+        put_char(buf, item->icon);
+        put_i32(buf, item->value);
+        put_f64(buf, item->weight);
+        put_i32(buf, item->type);
+        for (int p = 0; p < 10; p++) {
+            put_i32(buf, item->properties[p]);
+        }
+    }
+    return write_section(file, SAVE_TAG_ITEM_STORE, buf);
+}
+
+/**
+ * Write the whole game state in the binary format
+ */
+static int write_save(GameState* state, FILE* file) {
+    SaveBuffer buf = {0};
+    
+    int ok = write_file_header(file, SAVE_MAGIC);
+    
+    // Snapshot serial, matched against the journal header on load
+    if (ok) {
+        buf.size = 0;
+        put_i32(&buf, (int32_t)state->world.save_serial);
+        ok = write_section(file, SAVE_TAG_SNAPSHOT, &buf);
+    }
+    
+    if (ok) ok = write_player_section(file, state, &buf);
+    
+    // World
+    if (ok) {
+        buf.size = 0;
+        put_bytes(&buf, state->world.name, sizeof(state->world.name));
+        put_i32(&buf, state->world.chunk_count);
+        put_i32(&buf, state->world.chunk_width);
+        put_i32(&buf, state->world.chunk_height);
+        put_i32(&buf, state->world.seed);
+        put_i32(&buf, state->world.turn_counter);
+        put_i32(&buf, state->world.current_chunk_x);
+        put_i32(&buf, state->world.current_chunk_y);
+        put_i32(&buf, state->world.path_heuristic);
+        put_i64(&buf, (int64_t)state->world.world_time);
+        ok = write_section(file, SAVE_TAG_WORLD, &buf);
+    }
+    
+    // Encode every chunk up front so the directory knows their sizes
+    ChunkPayload* payloads = NULL;
+    if (ok) {
+        payloads = (ChunkPayload*)calloc(state->world.chunk_count + 1, sizeof(ChunkPayload));
+        if (!payloads) ok = 0;
+    }
+    for (int i = 0; ok && i < state->world.chunk_count; i++) {
+        ok = encode_chunk(&state->world, state->world.chunks[i], &payloads[i]);
+    }
+    
+    // Chunk directory: where each chunk's section payload will land
+    if (ok) {
+        long dir_start = ftell(file);
+        int64_t offset = (int64_t)dir_start + 8 + 4 + 
+                         (int64_t)state->world.chunk_count * SAVE_DIR_ENTRY_SIZE;
+        
+        buf.size = 0;
+        put_i32(&buf, state->world.chunk_count);
+        for (int i = 0; i < state->world.chunk_count; i++) {
+            WorldChunk* chunk = state->world.chunks[i];
+            
+            put_i32(&buf, chunk->x);
+            put_i32(&buf, chunk->y);
+            put_i32(&buf, chunk->width);
+            put_i32(&buf, chunk->height);
+            put_i32(&buf, chunk->active);
+            put_i32(&buf, payloads[i].encoding);
+            put_i64(&buf, offset + 8);
+            put_i64(&buf, (int64_t)chunk->last_updated);
+            
+            offset += 8 + SAVE_CHUNK_HEADER_SIZE + (int64_t)payloads[i].size;
+        }
+        ok = dir_start >= 0 && write_section(file, SAVE_TAG_DIRECTORY, &buf);
+    }
+    
+    for (int i = 0; ok && i < state->world.chunk_count; i++) {
+        ok = write_chunk_section(file, state->world.chunks[i], &payloads[i], &buf);
+    }
+    
+    for (int i = 0; payloads && i < state->world.chunk_count; i++) {
+        free(payloads[i].scratch);
+    }
+    free(payloads);
+    
+    if (ok) ok = write_enemy_section(file, state, &buf);
+    if (ok) ok = write_item_section(file, state, &buf);
+    
+    // End marker
+    if (ok) ok = write_section_header(file, SAVE_TAG_END, 0);
+    
+    free(buf.data);
+    return ok;
+}
+
+/**
+ * Build the journal path for a save file
+ */
+static void journal_path(const char* filename, char* out, size_t size) {
+    snprintf(out, size, "%s.journal", filename);
+}
+
+/**
+ * Write a full snapshot and drop the journal it replaces
+ * Writes to a temporary file and renames it over the target, so a save
+ * that is currently mapped for lazy loading stays readable.
+ */
+static int write_full_save(GameState* state, const char* filename) {
+#ifdef _WIN32
+    // Windows can't replace a file that is still mapped
+    if (!detach_save_mapping(&state->world)) return 0;
+#endif
+    
+    char temp_name[512];
+    snprintf(temp_name, sizeof(temp_name), "%s.tmp", filename);
+    
+    FILE* file = fopen(temp_name, "wb");
+    if (!file) return 0;
+    
+    // A new serial orphans any journal written against the previous snapshot
+    unsigned int previous_serial = state->world.save_serial;
+    state->world.save_serial = previous_serial + 1 > (unsigned int)time(NULL) ?
+                               previous_serial + 1 : (unsigned int)time(NULL);
+    
+    int ok = write_save(state, file) && sync_file(file);
+    if (fclose(file) != 0) ok = 0;
+    
+#ifdef _WIN32
+    if (ok) remove(filename);
+#endif
+    if (ok && rename(temp_name, filename) != 0) ok = 0;
+    
+    if (!ok) {
+        remove(temp_name);
+        state->world.save_serial = previous_serial;
+        return 0;
+    }
+    
+    char journal[512];
+    journal_path(filename, journal, sizeof(journal));
+    remove(journal);
+    
+    // Everything is on disk now
+    for (int i = 0; i < state->world.chunk_count; i++) {
+        state->world.chunks[i]->dirty = 0;
+    }
+    state->enemies_dirty = 0;
+    state->items_dirty = 0;
+    state->world.journal_batches = 0;
+    
+    if (filename != state->save_file) {
+        snprintf(state->save_file, sizeof(state->save_file), "%s", filename);
+    }
+    return 1;
+}
+
+/**
+ * Save the game to a file
+ */
+int save_game(GameState* state, const char* filename) {
+    if (!state || !filename) return 0;
+    
+    wait_for_save(state);
+    
+    if (!write_full_save(state, filename)) {
+        printf("Failed to write save file: %s\n", filename);
+        return 0;
+    }
+    
+    printf("Game saved to %s\n", filename);
+    return 1;
+}
+
+/**
+ * Check whether the next incremental save has to write a full snapshot
+ */
+static int needs_full_save(GameState* state, const char* filename) {
+    return state->world.save_serial == 0 ||
+           state->world.journal_batches < 0 ||
+           state->world.journal_batches >= SAVE_JOURNAL_MAX_BATCHES ||
+           strcmp(state->save_file, filename) != 0;
+}
+
+/**
+ * Append the dirty chunks, the enemy and item lists if they changed, and
+ * the player to the save's journal as one batch
+ */
+static int append_journal(GameState* state, const char* filename) {
+    char journal[512];
+    journal_path(filename, journal, sizeof(journal));
+    
+    // The first batch after a full save starts a fresh journal
+    FILE* file = fopen(journal, state->world.journal_batches == 0 ? "wb" : "ab");
+    if (!file) return 0;
+    
+    SaveBuffer buf = {0};
+    int ok = 1;
+    
+    if (state->world.journal_batches == 0) {
+        ok = write_file_header(file, SAVE_JOURNAL_MAGIC);
+        if (ok) {
+            put_i32(&buf, (int32_t)state->world.save_serial);
+            ok = write_section(file, SAVE_TAG_SNAPSHOT, &buf);
+        }
+    }
+    
+    // World clock and position
+    if (ok) {
+        buf.size = 0;
+        put_i32(&buf, state->world.turn_counter);
+        put_i32(&buf, state->world.current_chunk_x);
+        put_i32(&buf, state->world.current_chunk_y);
+        put_i32(&buf, state->world.path_heuristic);
+        put_i64(&buf, (int64_t)state->world.world_time);
+        ok = write_section(file, SAVE_TAG_WORLD_STATE, &buf);
+    }
+    
+    if (ok) ok = write_player_section(file, state, &buf);
+    
+    for (int i = 0; ok && i < state->world.chunk_count; i++) {
+        WorldChunk* chunk = state->world.chunks[i];
+        if (!chunk->dirty) continue;
+        
+        ChunkPayload payload;
+        ok = encode_chunk(&state->world, chunk, &payload) &&
+             write_chunk_section(file, chunk, &payload, &buf);
+        free(payload.scratch);
+    }
+    
+    if (ok && state->enemies_dirty) ok = write_enemy_section(file, state, &buf);
+    if (ok && state->items_dirty) ok = write_item_section(file, state, &buf);
+    
+    // The end marker commits the batch; a torn batch is ignored on load
+    if (ok) ok = write_section_header(file, SAVE_TAG_END, 0) && sync_file(file);
+    
+    long journal_size = ftell(file);
+    if (fclose(file) != 0) ok = 0;
+    free(buf.data);
+    
+    if (!ok) {
+        // Don't append after a partial batch; the next save rewrites everything
+        state->world.journal_batches = -1;
+        return 0;
+    }
+    
+    for (int i = 0; i < state->world.chunk_count; i++) {
+        state->world.chunks[i]->dirty = 0;
+    }
+    state->enemies_dirty = 0;
+    state->items_dirty = 0;
+    
+    state->world.journal_batches++;
+    if (journal_size < 0 || journal_size > SAVE_JOURNAL_MAX_BYTES) {
+        state->world.journal_batches = -1; // Compact on the next save
+    }
+    
+    return 1;
+}
+
+/**
+ * Save only what changed since the last save
+ * Falls back to a full save (which also compacts the journal away) when
+ * there is no matching snapshot on disk or the journal has grown past its
+ * limits.
+ */
+int save_game_incremental(GameState* state, const char* filename) {
+    if (!state || !filename) return 0;
+    
+    wait_for_save(state);
+    
+    if (needs_full_save(state, filename)) return write_full_save(state, filename);
+    return append_journal(state, filename);
+}
+
+// Background saving
+
+static void free_snapshot(GameState* snapshot);
+
+/**
+ * Copy the parts of the game state a save writes
+ * Tile blocks are copied flat; chunks still lazily backed by the save
+ * mapping share it. With dirty_only, just the dirty chunks are copied.
+ */
+static GameState* snapshot_game_state(GameState* state, int dirty_only) {
+    GameState* snapshot = (GameState*)malloc(sizeof(GameState));
+    if (!snapshot) return NULL;
+    
+    *snapshot = *state;
+    snapshot->world.chunks = NULL;
+    snapshot->world.chunk_count = 0;
+    snapshot->world.chunk_slots = NULL;
+    snapshot->world.chunk_slot_capacity = 0;
+    snapshot->world.last_chunk = NULL;
+    memset(&snapshot->enemies, 0, sizeof(EnemyStore));
+    memset(&snapshot->items, 0, sizeof(ItemStore));
+    snapshot->save_job = NULL;
+    snapshot->sim_pool = NULL;
+    snapshot->sim_path_buffers = NULL;
+    snapshot->sim_path_buffer_count = 0;
+    
+    int ok = 1;
+    
+    snapshot->world.chunks = (WorldChunk**)malloc((state->world.chunk_count + 1) * sizeof(WorldChunk*));
+    if (!snapshot->world.chunks) ok = 0;
+    
+    for (int i = 0; ok && i < state->world.chunk_count; i++) {
+        WorldChunk* chunk = state->world.chunks[i];
+        if (dirty_only && !chunk->dirty) continue;
+        
+        WorldChunk* copy = (WorldChunk*)malloc(sizeof(WorldChunk));
+        if (!copy) {
+            ok = 0;
+            break;
+        }
+        
+        *copy = *chunk;
+        copy->tiles = NULL;
+        copy->path_buffers = NULL;
+        copy->flow_field = NULL;
+        copy->fov = NULL;
+        copy->planes = NULL;
+        copy->sim_before = NULL;
+        if (chunk->packed_owned) {
+            copy->packed = NULL;
+            copy->packed_owned = 0;
+        }
+        snapshot->world.chunks[snapshot->world.chunk_count++] = copy;
+        
+        // Dormant chunks may be unpacked (and their buffer freed) while the worker runs
+        if (chunk->packed_owned) {
+            unsigned char* packed = (unsigned char*)malloc(chunk->packed_size);
+            if (!packed) {
+                ok = 0;
+                break;
+            }
+            memcpy(packed, chunk->packed, chunk->packed_size);
+            copy->packed = packed;
+            copy->packed_owned = 1;
+        }
+        
+        if (chunk->tiles) {
+            ok = alloc_chunk_tiles(copy);
+            if (ok) memcpy(copy->tiles, chunk->tiles, (size_t)chunk->width * chunk->height * sizeof(WorldTile));
+        }
+    }
+    
+    // Paths and memories aren't saved, so only the enemy fields are copied
+    if (ok) ok = enemy_store_copy(&snapshot->enemies, &state->enemies);
+    
+    if (ok) ok = item_store_copy(&snapshot->items, &state->items);
+    
+    if (!ok) {
+        free_snapshot(snapshot);
+        return NULL;
+    }
+    
+    return snapshot;
+}
+
+/**
+ * Free a snapshot (the save mapping belongs to the live state)
+ */
+static void free_snapshot(GameState* snapshot) {
+    for (int i = 0; snapshot->world.chunks && i < snapshot->world.chunk_count; i++) {
+        destroy_chunk(snapshot->world.chunks[i]);
+    }
+    
+    free(snapshot->world.chunks);
+    enemy_store_clear(&snapshot->enemies);
+    item_store_clear(&snapshot->items);
+    free(snapshot);
+}
+
+/**
+ * Worker thread: serialize the snapshot
+ */
+static void* save_worker(void* arg) {
+    SaveJob* job = (SaveJob*)arg;
+    
+    if (job->incremental) {
+        job->result = append_journal(job->snapshot, job->filename);
+    } else {
+        job->result = write_full_save(job->snapshot, job->filename);
+    }
+    
+    atomic_store(&job->done, 1);
+    return NULL;
+}
+
+/**
+ * Start saving in the background
+ * The state is copied on the calling thread and written by a worker, so
+ * the game keeps running while the file is written. Writes incrementally
+ * when possible, like save_game_incremental. Returns 0 if a save is
+ * already running or the snapshot could not be taken.
+ */
+int save_game_async(GameState* state, const char* filename) {
+    if (!state || !filename || state->save_job) return 0;
+    
+    SaveJob* job = (SaveJob*)calloc(1, sizeof(SaveJob));
+    if (!job) return 0;
+    
+    snprintf(job->filename, sizeof(job->filename), "%s", filename);
+    job->incremental = !needs_full_save(state, filename);
+    
+#ifdef _WIN32
+    // A full save renames over the mapped file, which Windows refuses
+    if (!job->incremental && !detach_save_mapping(&state->world)) {
+        free(job);
+        return 0;
+    }
+#endif
+    
+    job->snapshot = snapshot_game_state(state, job->incremental);
+    if (!job->snapshot) {
+        free(job);
+        return 0;
+    }
+    
+    if (pthread_create(&job->thread, NULL, save_worker, job) != 0) {
+        free_snapshot(job->snapshot);
+        free(job);
+        return 0;
+    }
+    
+    // The snapshot owns these changes now; later edits mark things dirty again
+    for (int i = 0; i < state->world.chunk_count; i++) {
+        state->world.chunks[i]->dirty = 0;
+    }
+    state->enemies_dirty = 0;
+    state->items_dirty = 0;
+    
+    state->save_job = job;
+    return 1;
+}
+
+/**
+ * Join a finished save and copy its bookkeeping back to the live state
+ */
+static SaveStatus finish_save(GameState* state) {
+    SaveJob* job = state->save_job;
+    pthread_join(job->thread, NULL);
+    
+    if (job->result) {
+        state->world.save_serial = job->snapshot->world.save_serial;
+        state->world.journal_batches = job->snapshot->world.journal_batches;
+        snprintf(state->save_file, sizeof(state->save_file), "%s", job->filename);
+    } else {
+        // Changes in the failed save are no longer flagged dirty; write everything next time
+        state->world.journal_batches = -1;
+    }
+    
+    SaveStatus status = job->result ? SAVE_DONE : SAVE_FAILED;
+    free_snapshot(job->snapshot);
+    free(job);
+    state->save_job = NULL;
+    return status;
+}
+
+/**
+ * Check on a background save without blocking
+ * Reports SAVE_DONE or SAVE_FAILED once when the save finishes.
+ */
+SaveStatus poll_save(GameState* state) {
+    if (!state || !state->save_job) return SAVE_IDLE;
+    if (!atomic_load(&state->save_job->done)) return SAVE_RUNNING;
+    
+    return finish_save(state);
+}
+
+/**
+ * Block until any background save has finished
+ */
+SaveStatus wait_for_save(GameState* state) {
+    if (!state || !state->save_job) return SAVE_IDLE;
+    
+    return finish_save(state);
+}
+
+// Binary reader
+
+/**
+ * Decode a section payload into the state being loaded
+ */
+static int read_section(GameState* state, const char* tag, SaveReader* r, int* expected_chunks) {
+    if (memcmp(tag, SAVE_TAG_SNAPSHOT, 4) == 0) {
+        state->world.save_serial = (unsigned int)get_i32(r);
+    }
+    else if (memcmp(tag, SAVE_TAG_PLAYER, 4) == 0) {
+        state->player.x = get_i32(r);
+        state->player.y = get_i32(r);
+        state->player.health = get_i32(r);
+        state->player.max_health = get_i32(r);
+        state->player.strength = get_i32(r);
+        state->player.level = get_i32(r);
+        get_raw(r, state->player.name, sizeof(state->player.name));
+        state->player.name[sizeof(state->player.name) - 1] = '\0';
+    }
+    else if (memcmp(tag, SAVE_TAG_WORLD, 4) == 0) {
+        if (state->world.chunks) return 0; // Duplicate world section
+        
+        get_raw(r, state->world.name, sizeof(state->world.name));
+        state->world.name[sizeof(state->world.name) - 1] = '\0';
+        int chunk_count = get_i32(r);
+        int chunk_width = get_i32(r);
+        int chunk_height = get_i32(r);
+        state->world.seed = get_i32(r);
+        state->world.turn_counter = get_i32(r);
+        state->world.current_chunk_x = get_i32(r);
+        state->world.current_chunk_y = get_i32(r);
+        state->world.path_heuristic = get_i32(r);
+        state->world.world_time = (time_t)get_i64(r);
+        
+        if (r->error || chunk_count < 0 || chunk_width <= 0 || chunk_height <= 0 ||
+            (long long)chunk_width * chunk_height > SAVE_MAX_CHUNK_TILES)
+            return 0;
+        
+        set_chunk_size(&state->world, chunk_width, chunk_height);
+        
+        // Chunks are counted back up as CHNK sections arrive
+        state->world.chunks = (WorldChunk**)calloc(chunk_count > 0 ? chunk_count : 1, sizeof(WorldChunk*));
+        if (!state->world.chunks) return 0;
+        *expected_chunks = chunk_count;
+    }
+    else if (memcmp(tag, SAVE_TAG_ENEMIES, 4) == 0) {
+        int count = get_i32(r);
+        if (r->error || count < 0 || (size_t)count > (r->size - r->pos) / SAVE_ENEMY_SIZE)
+            return 0;
+        
+        enemy_store_clear(&state->enemies);
+        
+        for (int i = 0; i < count; i++) {
+            AIEnemy enemy;
+            memset(&enemy, 0, sizeof(AIEnemy));
+            enemy.id = get_i32(r);
+            enemy.base.x = get_i32(r);
+            enemy.base.y = get_i32(r);
+            enemy.base.health = get_i32(r);
+            enemy.faction_id = get_i32(r);
+            enemy.ai_state = get_i32(r);
+            enemy.detection_radius = get_i32(r);
+            enemy.behavior_flags = get_i32(r);
+            enemy.base.icon = get_char(r);
+            enemy.base.name = "Goblin"; // Default
+            if (enemy_store_add(&state->enemies, &enemy) < 0) return 0;
+        }
+    }
+    else if (memcmp(tag, SAVE_TAG_ITEMS, 4) == 0 || memcmp(tag, SAVE_TAG_ITEM_STORE, 4) == 0) {
+        // ITEM (before v5) is just the records; tiles refer to them by position + 1
+        int placed = memcmp(tag, SAVE_TAG_ITEM_STORE, 4) == 0;
+        size_t record_size = placed ? SAVE_ITEM_STORE_SIZE : SAVE_ITEM_SIZE;
+        
+        int count = get_i32(r);
+        if (r->error || count < 0 || (size_t)count > (r->size - r->pos) / record_size)
+            return 0;
+        
+        item_store_clear(&state->items);
+        
+        for (int i = 0; i < count; i++) {
+            int handle = i + 1;
+            int x = ITEM_UNKNOWN, y = ITEM_UNKNOWN, below = 0;
+            if (placed) {
+                handle = get_i32(r);
+                x = get_i32(r);
+                y = get_i32(r);
+                below = get_i32(r);
+            }
+            
+            GameItem item;
+            get_raw(r, item.name, sizeof(item.name));
+            item.name[sizeof(item.name) - 1] = '\0';
+            item.icon = get_char(r);
+            item.value = get_i32(r);
+            item.weight = get_f64(r);
+            item.type = get_i32(r);
+            for (int p = 0; p < 10; p++) {
+                item.properties[p] = get_i32(r);
+            }
+            if (r->error || handle <= 0 || below < 0 || below > SLOT_MAP_MAX_SLOTS) return 0;
+            
+            // Chunk item lists are rebuilt once loading finishes
+            int slot = item_store_add(&state->items, &item, handle);
+            if (slot < 0) return 0;
+            state->items.entries[slot].x = x;
+            state->items.entries[slot].y = y;
+            state->items.entries[slot].below = (unsigned short)below;
+        }
+    }
+    
+    // Unknown sections are ignored
+    return !r->error;
+}
+
+/**
+ * Decode the tile block that ends a chunk section
+ */
+static int read_chunk_tiles(SaveReader* r, WorldTile* tiles, int count, int encoding) {
+    size_t available = r->size - r->pos;
+    
+    if (encoding == SAVE_CHUNK_PACKED) {
+        if (!unpack_tiles(r->data + r->pos, available, tiles, count)) return 0;
+    } else {
+        if (available != (size_t)count * sizeof(WorldTile)) return 0;
+        memcpy(tiles, r->data + r->pos, available);
+    }
+    
+    r->pos = r->size;
+    if (r->swap) swap_tiles(tiles, count);
+    return 1;
+}
+
+/**
+ * Create lazy chunks from the chunk directory; tiles stay in the mapping
+ */
+static int read_directory(GameState* state, SaveReader* r, const SaveMapping* mapping,
+                          int expected_chunks) {
+    if (!state->world.chunks || state->world.chunk_count != 0) return 0;
+    
+    int count = get_i32(r);
+    if (r->error || count != expected_chunks) return 0;
+    if ((size_t)count > (r->size - r->pos) / SAVE_DIR_ENTRY_SIZE) return 0;
+    
+    for (int i = 0; i < count; i++) {
+        int chunk_x = get_i32(r);
+        int chunk_y = get_i32(r);
+        int width = get_i32(r);
+        int height = get_i32(r);
+        int active = get_i32(r);
+        int encoding = get_i32(r);
+        int64_t offset = get_i64(r);
+        time_t last_updated = (time_t)get_i64(r);
+        
+        if (width <= 0 || height <= 0 || (long long)width * height > SAVE_MAX_CHUNK_TILES)
+            return 0;
+        if (offset < 0 || offset + SAVE_CHUNK_HEADER_SIZE > (int64_t)mapping->size)
+            return 0;
+        
+        const unsigned char* data = mapping->data + offset + SAVE_CHUNK_HEADER_SIZE;
+        size_t available = mapping->size - (size_t)offset - SAVE_CHUNK_HEADER_SIZE;
+        size_t packed_size = 0;
+        
+        if (encoding == SAVE_CHUNK_PACKED) {
+            packed_size = packed_tiles_size(data, available, width * height);
+            if (packed_size == 0) return 0;
+        } else if (encoding != SAVE_CHUNK_RAW ||
+                   (size_t)width * height * sizeof(WorldTile) > available) {
+            return 0;
+        }
+        
+        WorldChunk* chunk = (WorldChunk*)calloc(1, sizeof(WorldChunk));
+        if (!chunk) return 0;
+        state->world.chunks[state->world.chunk_count++] = chunk;
+        
+        chunk->x = chunk_x;
+        chunk->y = chunk_y;
+        chunk->width = width;
+        chunk->height = height;
+        chunk->active = active;
+        chunk->last_updated = last_updated;
+        
+        if (encoding == SAVE_CHUNK_PACKED) {
+            chunk->packed = data;
+            chunk->packed_size = packed_size;
+        } else {
+            chunk->mapped_tiles = (const WorldTile*)data;
+        }
+    }
+    
+    return !r->error;
+}
+
+/**
+ * Decode one chunk section eagerly (saves without a chunk directory)
+ */
+static int read_chunk_section(GameState* state, SaveReader* r, int expected_chunks, int encoding) {
+    if (!state->world.chunks || state->world.chunk_count >= expected_chunks)
+        return 0;
+    
+    int chunk_x = get_i32(r);
+    int chunk_y = get_i32(r);
+    int width = get_i32(r);
+    int height = get_i32(r);
+    int active = get_i32(r);
+    time_t last_updated = (time_t)get_i64(r);
+    
+    if (r->error || width <= 0 || height <= 0 || (long long)width * height > SAVE_MAX_CHUNK_TILES)
+        return 0;
+    
+    WorldChunk* chunk = create_chunk(chunk_x, chunk_y, width, height);
+    if (!chunk) return 0;
+    state->world.chunks[state->world.chunk_count++] = chunk;
+    
+    chunk->active = active;
+    chunk->last_updated = last_updated;
+    
+    return read_chunk_tiles(r, chunk->tiles, width * height, encoding);
+}
+
+/**
+ * Load a mapped binary save into a fresh state
+ * Sets *lazy when chunks were left in the mapping to be decoded on demand.
+ */
+static int load_game_binary(GameState* state, const SaveMapping* mapping, int* lazy) {
+    size_t pos = SAVE_MAGIC_SIZE + 8;
+    int expected_chunks = -1;
+    int have_directory = 0;
+    int ok = 0;
+    
+    while (pos + 8 <= mapping->size) {
+        const char* tag = (const char*)mapping->data + pos;
+        uint32_t length;
+        memcpy(&length, mapping->data + pos + 4, sizeof(length));
+        if (mapping->swap) swap_bytes(&length, sizeof(length));
+        pos += 8;
+        
+        if (length > mapping->size - pos) break; // Truncated file
+        
+        SaveReader r = {mapping->data + pos, length, 0, mapping->swap, 0};
+        pos += length;
+        
+        if (memcmp(tag, SAVE_TAG_END, 4) == 0) {
+            ok = 1;
+            break;
+        }
+        
+        if (memcmp(tag, SAVE_TAG_DIRECTORY, 4) == 0) {
+            if (!read_directory(state, &r, mapping, expected_chunks)) break;
+            have_directory = 1;
+        } else if (memcmp(tag, SAVE_TAG_CHUNK, 4) == 0 || memcmp(tag, SAVE_TAG_CHUNK_PACKED, 4) == 0) {
+            // Chunks listed in the directory are decoded on first touch
+            int encoding = tag[3] == 'P' ? SAVE_CHUNK_PACKED : SAVE_CHUNK_RAW;
+            if (!have_directory && !read_chunk_section(state, &r, expected_chunks, encoding)) break;
+        } else if (!read_section(state, tag, &r, &expected_chunks)) {
+            break;
+        }
+    }
+    
+    // Every chunk announced by the world section must be present
+    if (!ok || state->world.chunk_count != expected_chunks) return 0;
+    
+    *lazy = have_directory && expected_chunks > 0;
+    rebuild_chunk_index(&state->world);
+    return 1;
+}
+
+/**
+ * Apply a chunk record from the journal, replacing or adding the chunk
+ */
+static int apply_journal_chunk(GameState* state, SaveReader* r, int encoding) {
+    int chunk_x = get_i32(r);
+    int chunk_y = get_i32(r);
+    int width = get_i32(r);
+    int height = get_i32(r);
+    int active = get_i32(r);
+    time_t last_updated = (time_t)get_i64(r);
+    
+    if (r->error || width != state->world.chunk_width || height != state->world.chunk_height)
+        return 0;
+    
+    WorldChunk* chunk;
+    int index = get_chunk_index(state, chunk_x, chunk_y);
+    if (index >= 0) {
+        // Overwritten completely, so a lazy chunk needn't be decoded first
+        chunk = state->world.chunks[index];
+        free_packed_tiles(chunk);
+        if (!chunk->tiles && !alloc_chunk_tiles(chunk)) return 0;
+    } else {
+        // Chunk generated after the snapshot was written
+        WorldChunk** chunks = (WorldChunk**)realloc(state->world.chunks,
+                                                    (state->world.chunk_count + 1) * sizeof(WorldChunk*));
+        if (!chunks) return 0;
+        state->world.chunks = chunks;
+        
+        chunk = create_chunk(chunk_x, chunk_y, width, height);
+        if (!chunk) return 0;
+        state->world.chunks[state->world.chunk_count++] = chunk;
+        rebuild_chunk_index(&state->world);
+    }
+    
+    chunk->active = active;
+    chunk->last_updated = last_updated;
+    chunk->walk_version++;
+    invalidate_chunk_planes(chunk);
+    
+    return read_chunk_tiles(r, chunk->tiles, width * height, encoding);
+}
+
+/**
+ * Apply one committed journal batch
+ */
+static int apply_journal_batch(GameState* state, const unsigned char* data, size_t size, int swap) {
+    size_t pos = 0;
+    int unused = 0;
+    
+    while (pos + 8 <= size) {
+        const char* tag = (const char*)data + pos;
+        uint32_t length;
+        memcpy(&length, data + pos + 4, sizeof(length));
+        if (swap) swap_bytes(&length, sizeof(length));
+        pos += 8;
+        
+        SaveReader r = {data + pos, length, 0, swap, 0};
+        pos += length;
+        
+        if (memcmp(tag, SAVE_TAG_WORLD_STATE, 4) == 0) {
+            state->world.turn_counter = get_i32(&r);
+            state->world.current_chunk_x = get_i32(&r);
+            state->world.current_chunk_y = get_i32(&r);
+            state->world.path_heuristic = get_i32(&r);
+            state->world.world_time = (time_t)get_i64(&r);
+            if (r.error) return 0;
+        } else if (memcmp(tag, SAVE_TAG_CHUNK, 4) == 0) {
+            if (!apply_journal_chunk(state, &r, SAVE_CHUNK_RAW)) return 0;
+        } else if (memcmp(tag, SAVE_TAG_CHUNK_PACKED, 4) == 0) {
+            if (!apply_journal_chunk(state, &r, SAVE_CHUNK_PACKED)) return 0;
+        } else if (memcmp(tag, SAVE_TAG_WORLD, 4) == 0 ||
+                   !read_section(state, tag, &r, &unused)) {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * Replay the journal next to a save on top of the loaded snapshot
+ * Only batches closed by an end marker are applied, so a crash mid-append
+ * loses just the last batch. A journal left over from a different snapshot
+ * is ignored and overwritten by the next incremental save.
+ */
+static int replay_journal(GameState* state, const char* filename) {
+    char journal[512];
+    journal_path(filename, journal, sizeof(journal));
+    
+    FILE* file = fopen(journal, "rb");
+    if (!file) return 1; // No journal, nothing to do
+    
+    unsigned char* data = NULL;
+    size_t size = 0;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long length = ftell(file);
+        if (length > 0 && fseek(file, 0, SEEK_SET) == 0) {
+            data = (unsigned char*)malloc((size_t)length);
+            if (data && fread(data, 1, (size_t)length, file) == (size_t)length) {
+                size = (size_t)length;
+            }
+        }
+    }
+    fclose(file);
+    
+    // Header: magic, version, endian mark, then the snapshot serial
+    size_t header_size = SAVE_MAGIC_SIZE + 8 + 8 + 4;
+    if (size < header_size || memcmp(data, SAVE_JOURNAL_MAGIC, SAVE_MAGIC_SIZE) != 0 ||
+        memcmp(data + SAVE_MAGIC_SIZE + 8, SAVE_TAG_SNAPSHOT, 4) != 0) {
+        free(data);
+        return 1;
+    }
+    
+    uint32_t version, mark, serial;
+    memcpy(&version, data + SAVE_MAGIC_SIZE, sizeof(version));
+    memcpy(&mark, data + SAVE_MAGIC_SIZE + 4, sizeof(mark));
+    memcpy(&serial, data + header_size - 4, sizeof(serial));
+    
+    int swap = mark != SAVE_ENDIAN_MARK;
+    if (swap) {
+        swap_bytes(&version, sizeof(version));
+        swap_bytes(&serial, sizeof(serial));
+    }
+    
+    if ((swap && mark != 0x04030201u) || version < SAVE_MIN_VERSION || version > SAVE_VERSION ||
+        serial != state->world.save_serial) {
+        free(data);
+        return 1;
+    }
+    
+    size_t pos = header_size;
+    size_t batch_start = pos;
+    int batches = 0;
+    int ok = 1;
+    
+    while (pos + 8 <= size) {
+        const char* tag = (const char*)data + pos;
+        uint32_t length;
+        memcpy(&length, data + pos + 4, sizeof(length));
+        if (swap) swap_bytes(&length, sizeof(length));
+        
+        if (length > size - pos - 8) break; // Torn final batch
+        
+        if (memcmp(tag, SAVE_TAG_END, 4) == 0) {
+            if (!apply_journal_batch(state, data + batch_start, pos - batch_start, swap)) {
+                ok = 0;
+                break;
+            }
+            batches++;
+            batch_start = pos + 8 + length;
+        }
+        
+        pos += 8 + length;
+    }
+    
+    free(data);
+    
+    // Never append after a torn batch; compact it away on the next save
+    state->world.journal_batches = batch_start == size ? batches : -1;
+    return ok;
+}
+
+/**
+ * Load the game from a file
+ * Binary saves are memory-mapped and their chunks decoded lazily; legacy
+ * text saves are parsed in full. The caller's state is only replaced once
+ * the whole file has been read successfully.
+ */
+int load_game(GameState* state, const char* filename) {
+    if (!state || !filename) return 0;
+    
+    // Don't read a file that is still being written
+    wait_for_save(state);
+    
+    SaveMapping* mapping = map_save_file(filename);
+    if (!mapping) {
+        printf("Could not open save file: %s\n", filename);
+        return 0;
+    }
+    
+    GameState* loaded = create_game_state();
+    if (!loaded) {
+        free_save_mapping(mapping);
+        return 0;
+    }
+    
+    const unsigned char* header = mapping->data;
+    int ok = 0;
+    
+    if (mapping->size >= SAVE_MAGIC_SIZE + 8 && memcmp(header, SAVE_MAGIC, SAVE_MAGIC_SIZE) == 0) {
+        uint32_t version, mark;
+        memcpy(&version, header + SAVE_MAGIC_SIZE, sizeof(version));
+        memcpy(&mark, header + SAVE_MAGIC_SIZE + 4, sizeof(mark));
+        
+        mapping->swap = mark != SAVE_ENDIAN_MARK;
+        if (mapping->swap) swap_bytes(&version, sizeof(version));
+        
+        if (mapping->swap && mark != 0x04030201u) {
+            printf("Invalid save file format\n");
+        } else if (version < SAVE_MIN_VERSION || version > SAVE_VERSION) {
+            printf("Unsupported save version %u\n", version);
+        } else {
+            int lazy = 0;
+            ok = load_game_binary(loaded, mapping, &lazy);
+            
+            // Changes saved incrementally since the snapshot
+            if (ok && !replay_journal(loaded, filename)) {
+                printf("Corrupt save journal for %s\n", filename);
+                ok = 0;
+            }
+            
+            // Keep the mapping alive while chunks still point into it
+            if (ok && lazy) {
+                loaded->world.mapping = mapping;
+                mapping = NULL;
+            }
+        }
+    } else if (mapping->size >= 14 && memcmp(header, "ROGUELIKE_SAVE", 14) == 0) {
+        // Legacy text save - skip the rest of the header line
+        FILE* file = fopen(filename, "rb");
+        char buffer[256];
+        if (file && fgets(buffer, sizeof(buffer), file)) {
+            ok = load_game_text(loaded, file);
+        }
+        if (file) fclose(file);
+    } else {
+        printf("Invalid save file format\n");
+    }
+    
+    free_save_mapping(mapping);
+    
+    // Chunk item lists aren't saved; rebuild them from item positions
+    if (ok) rebuild_item_links(loaded);
+    
+    // Action stamps aren't saved; count every enemy as having acted on the
+    // saved turn, as add_enemy does, so none replays missed turns on load
+    if (ok) {
+        for (int i = 0; i < loaded->enemies.count; i++) {
+            loaded->enemies.last_action_time[i] = loaded->world.turn_counter;
+        }
+    }
+    
+    if (!ok) {
+        printf("Error reading save file: %s\n", filename);
+        destroy_game_state(loaded);
+        free(loaded);
+        return 0;
+    }
+    
+    // Swap the loaded state into the caller's, keeping its simulation threads
+    loaded->sim_pool = state->sim_pool;
+    loaded->sim_path_buffers = state->sim_path_buffers;
+    loaded->sim_path_buffer_count = state->sim_path_buffer_count;
+    state->sim_pool = NULL;
+    state->sim_path_buffers = NULL;
+    state->sim_path_buffer_count = 0;
+    destroy_game_state(state);
+    *state = *loaded;
+    free(loaded);
+    
+    state->is_loaded = 1;
+    snprintf(state->save_file, sizeof(state->save_file), "%s", filename);
+    printf("Game loaded from %s\n", filename);
+    return 1;
+}
+
+// Legacy text format
+
+/**
+ * Load a ROGUELIKE_SAVE_v1 text save (header line already consumed)
+ */
+int load_game_text(GameState* state, FILE* file) {
+    char buffer[256];
+    
+    // Read sections
+    while (fgets(buffer, sizeof(buffer), file)) {
+        buffer[strcspn(buffer, "\n")] = 0; // Remove newline
+        
+        if (strcmp(buffer, "PLAYER") == 0) {
+            // Read player data
+            if (fscanf(file, "%d %d %d %d %d %d %31s\n",
+                      &state->player.x, &state->player.y,
+                      &state->player.health, &state->player.max_health,
+                      &state->player.strength, &state->player.level,
+                      state->player.name) != 7) {
+                printf("Error reading player data\n");
+                return 0;
+            }
+        }
+        else if (strcmp(buffer, "WORLD") == 0) {
+            // Read world data
+            long long world_time;
+            if (fscanf(file, "%63s %d %d %d %d %lld\n",
+                      state->world.name, &state->world.chunk_count,
+                      &state->world.chunk_width, &state->world.chunk_height,
+                      &state->world.seed, &world_time) != 6) {
+                printf("Error reading world data\n");
+                return 0;
+            }
+            state->world.world_time = (time_t)world_time;
+            set_chunk_size(&state->world, state->world.chunk_width, state->world.chunk_height);
+            
+            // Allocate chunk array
+            state->world.chunks = (WorldChunk**)calloc(state->world.chunk_count, sizeof(WorldChunk*));
+            if (!state->world.chunks) return 0;
+        }
+        else if (strcmp(buffer, "CHUNKS") == 0) {
+            if (!state->world.chunks) return 0;
+            
+            // Read chunk data
+            for (int i = 0; i < state->world.chunk_count; i++) {
+                // Read chunk header
+                int chunk_x, chunk_y, width, height, active;
+                long long last_updated;
+                if (fscanf(file, "CHUNK %d %d %d %d %d %lld\n",
+                          &chunk_x, &chunk_y, &width, &height,
+                          &active, &last_updated) != 6) {
+                    printf("Error reading chunk header\n");
+                    return 0;
+                }
+                
+                // Create chunk
+                state->world.chunks[i] = create_chunk(chunk_x, chunk_y, width, height);
+                WorldChunk* chunk = state->world.chunks[i];
+                if (!chunk) {
+                    printf("Out of memory reading chunk\n");
+                    return 0;
+                }
+                chunk->active = active;
+                chunk->last_updated = (time_t)last_updated;
+                
+                // Read tiles
+                for (int y = 0; y < height; y++) {
+                    // Read tile data for this row
+                    for (int x = 0; x < width; x++) {
+                        WorldTile* tile = CHUNK_TILE(chunk, x, y);
+                        int type, walkable, transparent, entity_id, item_id;
+                        char display_char;
+                        
+                        if (fscanf(file, "%d %c %d %d %d %d\n",
+                                  &type, &display_char,
+                                  &walkable, &transparent,
+                                  &entity_id, &item_id) != 6) {
+                            printf("Error reading tile data\n");
+                            return 0;
+                        }
+                        
+                        tile->type = (unsigned char)type;
+                        tile->display_char = display_char;
+                        tile_set_flags(tile, walkable, transparent);
+                        tile->entity_id = entity_id;
+                        tile->item_id = item_id;
+                    }
+                }
+            }
+            
+            rebuild_chunk_index(&state->world);
+        }
+        else if (strncmp(buffer, "ENEMIES", 7) == 0) {
+            // Read enemy count
+            int enemy_count;
+            if (sscanf(buffer, "ENEMIES %d", &enemy_count) != 1) {
+                printf("Error reading enemy count\n");
+                return 0;
+            }
+            
+            // Read each enemy
+            enemy_store_clear(&state->enemies);
+            for (int i = 0; i < enemy_count; i++) {
+                AIEnemy enemy;
+                memset(&enemy, 0, sizeof(AIEnemy));
+                
+                if (fscanf(file, "%d %d %d %d %d %d %d %d\n",
+                          &enemy.id, &enemy.base.x, &enemy.base.y,
+                          &enemy.base.health, &enemy.faction_id,
+                          &enemy.ai_state, &enemy.detection_radius,
+                          &enemy.behavior_flags) != 8) {
+                    printf("Error reading enemy data\n");
+                    return 0;
+                }
+                
+                // Set icon and name based on faction/type
+                enemy.base.icon = 'G'; // Default goblin for now
+                enemy.base.name = "Goblin"; // Default
+                if (enemy_store_add(&state->enemies, &enemy) < 0) return 0;
+            }
+        }
+        else if (strncmp(buffer, "ITEMS", 5) == 0) {
+            // Read item count
+            int item_count;
+            if (sscanf(buffer, "ITEMS %d", &item_count) != 1) {
+                printf("Error reading item count\n");
+                return 0;
+            }
+            
+            // Read each item; tiles refer to them by position + 1
+            item_store_clear(&state->items);
+            for (int i = 0; i < item_count; i++) {
+                GameItem item;
+                memset(&item, 0, sizeof(GameItem));
+                if (fscanf(file, "%31s %c %d %lf %d\n",
+                          item.name, &item.icon,
+                          &item.value, &item.weight, &item.type) != 5) {
+                    printf("Error reading item data\n");
+                    return 0;
+                }
+                
+                int slot = item_store_add(&state->items, &item, i + 1);
+                if (slot < 0) return 0;
+                state->items.entries[slot].x = ITEM_UNKNOWN;
+                state->items.entries[slot].y = ITEM_UNKNOWN;
+            }
+        }
+        else if (strcmp(buffer, "END") == 0) {
+            break;
+        }
+    }
+    
+    
+    // Every chunk announced by the world section must have been read
+    if (!state->world.chunks) return 0;
+    for (int i = 0; i < state->world.chunk_count; i++) {
+        if (!state->world.chunks[i]) return 0;
+    }
+    
+    return 1;
+}
@@ -0,0 +1,89 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include "gamestate.h"
+
+/*
+ * Binary save format (all integers in the writer's byte order):
+ *
+ *   header:   "RGLKSAVE" | u32 version | u32 endian mark (0x01020304)
+ *   sections: char tag[4] | u32 payload length | payload
+ *
+ *   PLYR  player position and stats
+ *   WRLD  world settings, chunk count, turn counter
+ *   CDIR  chunk directory: position, size, encoding and file offset of every chunk (v3+)
+ *   CHNK  one per chunk: chunk header followed by width * height raw WorldTiles
+ *   CHNP  like CHNK, but the tiles are packed (see chunkpack.h); used when
+ *         the chunk has at most CHUNK_PACK_MAX_PALETTE distinct tiles
+ *   SNAP  serial identifying this snapshot
+ *   ENMY  enemy count followed by fixed-size enemy records
+ *   ITMS  item count followed by fixed-size records: handle, position and
+ *         the item below it on the same tile, then the item (v5+)
+ *   ITEM  item count followed by fixed-size item records (before v5; tiles
+ *         refer to items by position in the list)
+ *   END   empty, terminates the file
+ *
+ * Incremental saves append batches to "<save>.journal" instead of rewriting
+ * the snapshot. The journal starts with "RGLKJRNL", the same version and
+ * endian mark, and a SNAP section naming the snapshot it applies to. Each
+ * batch holds a WSTA section (turn counter, current chunk, world time), PLYR,
+ * the chunks that changed as CHNK sections, ENMY and ITMS when they changed,
+ * and is closed by END. A full save rewrites the snapshot and deletes the
+ * journal.
+ *
+ * Unknown sections are skipped by length. A reader on a machine with the
+ * other byte order swaps every field on load. Saves with a chunk directory
+ * are memory-mapped and each chunk is only decoded when first touched.
+ */
+
+#define SAVE_MAGIC          "RGLKSAVE"
+#define SAVE_MAGIC_SIZE     8
+#define SAVE_VERSION        5
+#define SAVE_MIN_VERSION    2
+#define SAVE_ENDIAN_MARK    0x01020304u
+#define SAVE_TEXT_HEADER    "ROGUELIKE_SAVE_v1"
+#define SAVE_JOURNAL_MAGIC  "RGLKJRNL"
+
+// Journal compaction thresholds: past either, the next save is a full one
+#define SAVE_JOURNAL_MAX_BATCHES 16
+#define SAVE_JOURNAL_MAX_BYTES   (8L * 1024 * 1024)
+
+// Section tags
+#define SAVE_TAG_PLAYER     "PLYR"
+#define SAVE_TAG_WORLD      "WRLD"
+#define SAVE_TAG_WORLD_STATE "WSTA"
+#define SAVE_TAG_SNAPSHOT   "SNAP"
+#define SAVE_TAG_DIRECTORY  "CDIR"
+#define SAVE_TAG_CHUNK      "CHNK"
+#define SAVE_TAG_CHUNK_PACKED "CHNP"
+#define SAVE_TAG_ENEMIES    "ENMY"
+#define SAVE_TAG_ITEMS      "ITEM"
+#define SAVE_TAG_ITEM_STORE "ITMS"
+#define SAVE_TAG_END        "END "
+
+typedef struct SaveMapping SaveMapping;
+typedef struct SaveJob SaveJob;
+
+// State of a background save
+typedef enum {
+    SAVE_IDLE = 0,      // No save running
+    SAVE_RUNNING,       // Worker is still writing
+    SAVE_DONE,          // Finished successfully (reported once)
+    SAVE_FAILED         // Finished with an error (reported once)
+} SaveStatus;
+
+// Background saving
+int save_game_async(GameState* state, const char* filename);
+SaveStatus poll_save(GameState* state);
+SaveStatus wait_for_save(GameState* state);
+
+// Lazy chunk loading
+int materialize_chunk(World* world, WorldChunk* chunk);
+int peek_chunk_tile(const World* world, const WorldChunk* chunk, int x, int y, WorldTile* out);
+void release_chunk_tiles(World* world, WorldChunk* chunk);
+void free_save_mapping(SaveMapping* mapping);
+
+// Legacy text format
+int load_game_text(GameState* state, FILE* file);
+
+#endif /* SAVEGAME_H */
@@ -0,0 +1,442 @@
+#include "scheduler.h"
+#include "flowfield.h"
+#include "fov.h"
+#include "pathfinding.h"
+#include "platform.h"
+#include "workpool.h"
+#include "savegame.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Most enemies fetched by one spatial query (chunks are queried in pieces this size)
+#define SIM_QUERY_MAX 256
+
+// Chunks within SIM_COARSE_RADIUS of the player's chunk
+#define SIM_WINDOW_SIDE (2 * SIM_COARSE_RADIUS + 1)
+
+// A due chunk with world processes to run
+typedef struct DueChunk {
+    WorldChunk* chunk;
+    int ready;              // Its copy of last turn was taken (0 = skip its world processes)
+} DueChunk;
+
+// The world processes of one turn, handed to the work pool
+typedef struct SimBatch {
+    GameState* state;
+    DueChunk* due;
+} SimBatch;
+
+// An enemy acting this turn
+typedef struct Actor {
+    int index;              // Store index
+    int id;                 // Handle, which orders the resolve phase
+    int turns;              // Turns it acts for (more than one when waking)
+} Actor;
+
+// The enemies of the chunks due this turn
+typedef struct ActorList {
+    Actor* actors;
+    int count;
+    int capacity;
+} ActorList;
+
+// One round of enemy decisions, handed to the work pool
+typedef struct DecideBatch {
+    GameState* state;
+    const FlowField* field; // This turn's flow field toward the player
+    const int* members;     // Store indices of the enemies deciding
+    EnemyIntent* intents;   // One per member
+    int turn;               // Turn the round plays
+} DecideBatch;
+
+/**
+ * Floor modulo for a positive divisor
+ */
+static int floor_mod(int value, int divisor) {
+    int rest = value % divisor;
+    return rest < 0 ? rest + divisor : rest;
+}
+
+/**
+ * Chunk distance from the player's chunk to a chunk
+ */
+static int chunk_distance(const GameState* state, int chunk_x, int chunk_y) {
+    int player_chunk_x, player_chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, state->player.x, state->player.y,
+                          &player_chunk_x, &player_chunk_y, &local_x, &local_y);
+
+    int dx = abs(chunk_x - player_chunk_x);
+    int dy = abs(chunk_y - player_chunk_y);
+    return dx > dy ? dx : dy;
+}
+
+/**
+ * How often a chunk is simulated, from its distance to the player
+ */
+SimTier chunk_sim_tier(const GameState* state, int chunk_x, int chunk_y) {
+    if (!state) return SIM_FROZEN;
+
+    int distance = chunk_distance(state, chunk_x, chunk_y);
+    if (distance <= SIM_FULL_RADIUS) return SIM_FULL;
+    if (distance <= SIM_COARSE_RADIUS) return SIM_COARSE;
+    return SIM_FROZEN;
+}
+
+/**
+ * Whether a coarse chunk is updated this turn
+ * Each 2x2 block of chunks spreads over four turns, so the work stays even.
+ */
+static int coarse_turn(int chunk_x, int chunk_y, int turn) {
+    return floor_mod(turn + chunk_x + 2 * chunk_y, SIM_COARSE_INTERVAL) == 0;
+}
+
+/**
+ * Number of turns an enemy acts for now: one, or the turns it missed
+ * (at most SIM_CATCHUP_TURNS) if it was frozen for longer than a coarse interval
+ */
+static int enemy_turns_due(const EnemyStore* enemies, int index, int turn) {
+    int missed = turn - enemies->last_action_time[index];
+    if (missed <= SIM_COARSE_INTERVAL) return 1;
+    return missed < SIM_CATCHUP_TURNS ? missed : SIM_CATCHUP_TURNS;
+}
+
+/**
+ * Copy the strip of a neighbouring chunk (dx, dy in -1..1) that borders a
+ * chunk into the chunk's before buffer; empty tiles if it isn't loaded
+ * Packed or lazily loaded neighbours are read in place, not decoded.
+ */
+static void capture_neighbour(GameState* state, WorldChunk* chunk, int dx, int dy) {
+    int index = get_chunk_index(state, chunk->x + dx, chunk->y + dy);
+    const WorldChunk* other = index >= 0 ? state->world.chunks[index] : NULL;
+
+    // Where no chunk is loaded the world is empty
+    WorldTile empty;
+    memset(&empty, 0, sizeof(empty));
+    init_tile(&empty, TILE_EMPTY);
+
+    int min_x = dx < 0 ? -1 : dx > 0 ? chunk->width : 0;
+    int max_x = dx < 0 ? -1 : dx > 0 ? chunk->width : chunk->width - 1;
+    int min_y = dy < 0 ? -1 : dy > 0 ? chunk->height : 0;
+    int max_y = dy < 0 ? -1 : dy > 0 ? chunk->height : chunk->height - 1;
+
+    for (int y = min_y; y <= max_y; y++) {
+        for (int x = min_x; x <= max_x; x++) {
+            WorldTile* before = CHUNK_TILE_BEFORE(chunk, x, y);
+            if (!other || !peek_chunk_tile(&state->world, other, x - dx * chunk->width,
+                                           y - dy * chunk->height, before)) {
+                *before = empty;
+            }
+        }
+    }
+}
+
+/**
+ * Copy a chunk's tiles and the ring of tiles around it into its before
+ * buffer, so world processes read last turn's state across chunk edges
+ * Returns 0 if the buffer can't be allocated.
+ */
+static int capture_chunk_before(GameState* state, WorldChunk* chunk) {
+    if (!chunk->sim_before) {
+        size_t tiles = (size_t)(chunk->width + 2) * (chunk->height + 2);
+        chunk->sim_before = (WorldTile*)malloc(tiles * sizeof(WorldTile));
+        if (!chunk->sim_before) return 0;
+    }
+
+    for (int y = 0; y < chunk->height; y++) {
+        memcpy(CHUNK_TILE_BEFORE(chunk, 0, y), CHUNK_TILE(chunk, 0, y), chunk->width * sizeof(WorldTile));
+    }
+
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (dx != 0 || dy != 0) capture_neighbour(state, chunk, dx, dy);
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Work pool item: run one due chunk's world processes
+ */
+static void simulate_due_chunk(void* context, int item, int thread) {
+    SimBatch* batch = (SimBatch*)context;
+    DueChunk* due = &batch->due[item];
+    (void)thread;
+
+    if (due->ready) simulate_world_chunk(batch->state, due->chunk);
+}
+
+/**
+ * Append an actor, growing the list as needed
+ * Returns 0 if memory runs out.
+ */
+static int add_actor(ActorList* list, int index, int id, int turns) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        Actor* actors = (Actor*)realloc(list->actors, capacity * sizeof(Actor));
+        if (!actors) return 0;
+        list->actors = actors;
+        list->capacity = capacity;
+    }
+
+    Actor* actor = &list->actors[list->count++];
+    actor->index = index;
+    actor->id = id;
+    actor->turns = turns;
+    return 1;
+}
+
+/**
+ * Add the enemies standing in a chunk that haven't acted this turn
+ * Each is stamped as it is added, so no enemy acts twice in a turn.
+ * Returns 0 if memory runs out.
+ */
+static int collect_chunk_enemies(GameState* state, const WorldChunk* chunk, int turn, ActorList* list) {
+    EnemyStore* enemies = &state->enemies;
+    int found[SIM_QUERY_MAX];
+
+    // At most one enemy per tile, so pieces of SIM_QUERY_MAX tiles never overflow
+    int piece_width = chunk->width < SIM_QUERY_MAX ? chunk->width : SIM_QUERY_MAX;
+    int piece_height = SIM_QUERY_MAX / piece_width;
+    int origin_x = chunk->x * chunk->width;
+    int origin_y = chunk->y * chunk->height;
+
+    for (int y = 0; y < chunk->height; y += piece_height) {
+        for (int x = 0; x < chunk->width; x += piece_width) {
+            int max_x = x + piece_width < chunk->width ? x + piece_width : chunk->width;
+            int max_y = y + piece_height < chunk->height ? y + piece_height : chunk->height;
+            int count = get_enemies_in_rect(state, origin_x + x, origin_y + y,
+                                            origin_x + max_x - 1, origin_y + max_y - 1,
+                                            found, SIM_QUERY_MAX);
+            if (count > SIM_QUERY_MAX) count = SIM_QUERY_MAX;
+
+            for (int i = 0; i < count; i++) {
+                int index = found[i];
+                if (enemies->last_action_time[index] >= turn) continue;
+
+                if (!add_actor(list, index, enemies->id[index], enemy_turns_due(enemies, index, turn))) {
+                    return 0;
+                }
+                enemies->last_action_time[index] = turn;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * qsort comparator: actors by enemy id
+ */
+static int compare_actors(const void* a, const void* b) {
+    int id_a = ((const Actor*)a)->id;
+    int id_b = ((const Actor*)b)->id;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+/**
+ * Work pool item: one enemy decides, with its thread's A* buffers
+ */
+static void decide_member(void* context, int item, int thread) {
+    DecideBatch* batch = (DecideBatch*)context;
+
+    decide_enemy_ai(batch->state, batch->field, &batch->state->sim_path_buffers[thread],
+                    batch->members[item], batch->turn, &batch->intents[item]);
+}
+
+/**
+ * Free the per-thread A* buffers
+ */
+static void free_sim_path_buffers(GameState* state) {
+    for (int i = 0; i < state->sim_path_buffer_count; i++) {
+        free_path_buffers(state->sim_path_buffers[i]);
+    }
+    free(state->sim_path_buffers);
+    state->sim_path_buffers = NULL;
+    state->sim_path_buffer_count = 0;
+}
+
+/**
+ * Give every simulation thread a slot for A* buffers
+ * Returns 0 if memory runs out.
+ */
+static int reserve_path_buffers(GameState* state) {
+    int threads = work_pool_threads(state->sim_pool);
+    if (state->sim_path_buffers && state->sim_path_buffer_count == threads) return 1;
+
+    free_sim_path_buffers(state);
+    state->sim_path_buffers = (PathBuffers**)calloc(threads, sizeof(PathBuffers*));
+    if (!state->sim_path_buffers) return 0;
+
+    state->sim_path_buffer_count = threads;
+    return 1;
+}
+
+/**
+ * Run the AI of every enemy in the due chunks
+ * Enemies decide in parallel against the world as the turn began, then
+ * their intents are resolved one by one in id order. Enemies catching up
+ * on missed turns play them in rounds, oldest first; each round is a
+ * decide and a resolve of its own. Time spent is added to PHASE_DECIDE
+ * and PHASE_RESOLVE from phase_start on.
+ */
+static void simulate_enemies(GameState* state, const FlowField* field, WorldChunk* const* due,
+                             int due_count, int turn, double* phase_start) {
+    ActorList list = { NULL, 0, 0 };
+    int ok = 1;
+
+    for (int i = 0; ok && i < due_count; i++) {
+        int before = list.count;
+        ok = collect_chunk_enemies(state, due[i], turn, &list);
+
+        // Decode the chunk's window and build its planes for the decide phase
+        if (ok && list.count > before) {
+            ChunkWindow window;
+            get_chunk_window(state, due[i]->x, due[i]->y, &window);
+        }
+    }
+
+    EnemyIntent* intents = NULL;
+    int* members = NULL;
+    if (ok && list.count > 0) {
+        intents = (EnemyIntent*)malloc(list.count * sizeof(EnemyIntent));
+        members = (int*)malloc(list.count * sizeof(int));
+        ok = intents && members && reserve_path_buffers(state);
+    }
+
+    if (ok && list.count > 0) {
+        qsort(list.actors, list.count, sizeof(Actor), compare_actors);
+        state->enemies_dirty = 1;
+
+        int rounds = 0;
+        for (int i = 0; i < list.count; i++) {
+            if (list.actors[i].turns > rounds) rounds = list.actors[i].turns;
+        }
+
+        for (int round = rounds - 1; round >= 0; round--) {
+            int count = 0;
+            for (int i = 0; i < list.count; i++) {
+                if (list.actors[i].turns > round) members[count++] = list.actors[i].index;
+            }
+
+            DecideBatch batch = { state, field, members, intents, turn - round };
+            work_pool_run(state->sim_pool, count, decide_member, &batch);
+            end_sim_phase(state, PHASE_DECIDE, phase_start);
+
+            resolve_enemy_ai(state, intents, count);
+            end_sim_phase(state, PHASE_RESOLVE, phase_start);
+        }
+    } else if (!ok) {
+        // Out of memory: enemies collected so far act one at a time
+        for (int i = 0; i < list.count; i++) {
+            for (int step = list.actors[i].turns - 1; step >= 0; step--) {
+                process_enemy_ai(state, list.actors[i].index, turn - step);
+            }
+        }
+        state->enemies_dirty = 1;
+        end_sim_phase(state, PHASE_RESOLVE, phase_start);
+    }
+    end_sim_phase(state, PHASE_DECIDE, phase_start);
+
+    free(intents);
+    free(members);
+    free(list.actors);
+}
+
+/**
+ * Advance the chunks around the player and the enemies in them by one turn
+ */
+void simulate_turn(GameState* state) {
+    if (!state) return;
+
+    double phase_start = platform_time_ms();
+    int turn = state->world.turn_counter;
+    int player_chunk_x, player_chunk_y, local_x, local_y;
+    world_to_chunk_coords(&state->world, state->player.x, state->player.y,
+                          &player_chunk_x, &player_chunk_y, &local_x, &local_y);
+
+    // Chunks due this turn; everything further out stays frozen
+    WorldChunk* due[SIM_WINDOW_SIDE * SIM_WINDOW_SIDE];
+    int due_count = 0;
+
+    // The due chunks that have world processes to run
+    DueChunk work[SIM_WINDOW_SIDE * SIM_WINDOW_SIDE];
+    int work_count = 0;
+    time_t now = time(NULL);
+
+    for (int dy = -SIM_COARSE_RADIUS; dy <= SIM_COARSE_RADIUS; dy++) {
+        for (int dx = -SIM_COARSE_RADIUS; dx <= SIM_COARSE_RADIUS; dx++) {
+            int chunk_x = player_chunk_x + dx;
+            int chunk_y = player_chunk_y + dy;
+            int index = get_chunk_index(state, chunk_x, chunk_y);
+            if (index < 0 || !state->world.chunks[index]->active) continue;
+            if (chunk_sim_tier(state, chunk_x, chunk_y) == SIM_COARSE &&
+                !coarse_turn(chunk_x, chunk_y, turn)) {
+                continue;
+            }
+
+            WorldChunk* chunk = state->world.chunks[index];
+            chunk->last_updated = now;
+            due[due_count++] = chunk;
+
+            // Chunks that run processes are decoded here, not on the worker threads
+            if (!chunk_has_world_processes(chunk) || !get_chunk_at(state, chunk_x, chunk_y)) continue;
+            work[work_count].chunk = chunk;
+            work[work_count].ready = 0;
+            work_count++;
+        }
+    }
+
+    // Every chunk takes its copy of last turn before any of them changes
+    for (int i = 0; i < work_count; i++) {
+        work[i].ready = capture_chunk_before(state, work[i].chunk);
+    }
+
+    SimBatch batch = { state, work };
+    work_pool_run(state->sim_pool, work_count, simulate_due_chunk, &batch);
+
+    end_sim_phase(state, PHASE_WORLD, &phase_start);
+
+    // Refresh the shared flow field toward the player and what the player
+    // sees before any enemy moves
+    FlowField* field = update_flow_field(state, state->player.x, state->player.y);
+    update_fov(state);
+    end_sim_phase(state, PHASE_FIELDS, &phase_start);
+
+    simulate_enemies(state, field, due, due_count, turn, &phase_start);
+}
+
+/**
+ * Set how many threads simulate chunks and decide enemy moves (1 = the calling thread)
+ * More threads than processors only take turns on the same cores, so the
+ * count is capped at platform_cpu_count. Returns 0 if the threads can't be
+ * started; the old setting stays then.
+ */
+int set_sim_threads(GameState* state, int threads) {
+    if (!state || threads < 1) return 0;
+    int cpus = platform_cpu_count();
+    if (threads > cpus) threads = cpus;
+    if (work_pool_threads(state->sim_pool) == threads) return 1;
+
+    WorkPool* pool = NULL;
+    if (threads > 1) {
+        pool = work_pool_create(threads);
+        if (!pool) return 0;
+    }
+
+    free_sim_threads(state);
+    state->sim_pool = pool;
+    return 1;
+}
+
+/**
+ * Stop the simulation threads and free their buffers
+ */
+void free_sim_threads(GameState* state) {
+    if (!state) return;
+
+    work_pool_destroy(state->sim_pool);
+    state->sim_pool = NULL;
+    free_sim_path_buffers(state);
+}
@@ -0,0 +1,54 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "gamestate.h"
+
+/*
+ * Decides which chunks are simulated each turn, by their distance (in
+ * chunks, largest of dx and dy) from the chunk holding the player:
+ *
+ *   full    every turn; covers everything the player can see or reach
+ *   coarse  once every SIM_COARSE_INTERVAL turns, one step for the enemies
+ *   frozen  not at all; decoded tiles are packed until touched again
+ *
+ * A due chunk runs its world processes once; they don't catch up on turns
+ * it spent coarse or frozen. Each enemy remembers the turn it last acted
+ * (last_action_time); one that missed more than a coarse interval replays
+ * up to SIM_CATCHUP_TURNS of them in a batch.
+ * Per-turn work is bounded by the chunks around the player, not world size.
+ *
+ * The world processes of the chunks due in a turn (simulate_world_chunk)
+ * run on a work pool when more than one thread is set. Each chunk first
+ * copies its tiles and the ring around them as they were last turn
+ * (CHUNK_TILE_BEFORE); processes read that copy and write only their own
+ * chunk, so the result is the same for any thread count. Chunks without
+ * world processes (chunk_has_world_processes) skip both the copy and the
+ * pool.
+ *
+ * Enemies then act in two phases. In the decide phase each enemy picks its
+ * move on the pool, reading the world as the phase began (peek lookups that
+ * never decode chunks) and writing only its own intent and path, with one
+ * set of A* buffers per thread. The resolve phase then applies the intents
+ * on the calling thread in enemy-id order; a move onto a tile taken earlier
+ * in the phase fails and the enemy stays put. Enemies catching up on missed
+ * turns play them as rounds of decide and resolve.
+ */
+
+#define SIM_FULL_RADIUS     1   // Chunks simulated every turn
+#define SIM_COARSE_RADIUS   3   // Chunks simulated every SIM_COARSE_INTERVAL turns
+#define SIM_COARSE_INTERVAL 4   // Turns between coarse updates
+#define SIM_CATCHUP_TURNS   32  // Most turns an enemy replays when it wakes
+
+typedef enum {
+    SIM_FROZEN = 0,
+    SIM_COARSE,
+    SIM_FULL
+} SimTier;
+
+// Scheduler API
+SimTier chunk_sim_tier(const GameState* state, int chunk_x, int chunk_y);
+void simulate_turn(GameState* state);
+int set_sim_threads(GameState* state, int threads);
+void free_sim_threads(GameState* state);
+
+#endif /* SCHEDULER_H */
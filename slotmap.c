@@ -0,0 +1,152 @@
+#include "slotmap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Push a slot onto the free stack
+ */
+static int push_free_slot(SlotMap* map, int slot) {
+    if (map->free_count == map->free_capacity) {
+        int capacity = map->free_capacity ? map->free_capacity * 2 : 16;
+        int* resized = (int*)realloc(map->free_slots, (size_t)capacity * sizeof(int));
+        if (!resized) return 0;
+        map->free_slots = resized;
+        map->free_capacity = capacity;
+    }
+    
+    map->free_slots[map->free_count++] = slot;
+    return 1;
+}
+
+/**
+ * Append free slots until there are at least count of them
+ */
+static int grow_slots(SlotMap* map, int count) {
+    if (count > SLOT_MAP_MAX_SLOTS) return 0;
+    
+    if (count > map->slot_capacity) {
+        int capacity = map->slot_capacity ? map->slot_capacity : 16;
+        while (capacity < count) capacity *= 2;
+        if (capacity > SLOT_MAP_MAX_SLOTS) capacity = SLOT_MAP_MAX_SLOTS;
+        SlotEntry* resized = (SlotEntry*)realloc(map->slots, (size_t)capacity * sizeof(SlotEntry));
+        if (!resized) return 0;
+        map->slots = resized;
+        map->slot_capacity = capacity;
+    }
+    
+    while (map->slot_count < count) {
+        map->slots[map->slot_count].value = SLOT_FREE;
+        map->slots[map->slot_count].generation = 1;
+        map->slot_count++;
+    }
+    return 1;
+}
+
+/**
+ * Claim a slot holding value and return its handle (0 if none is left)
+ * A handle of 0 gets a free slot; a handle from a save claims its own
+ * slot and generation.
+ */
+int slot_map_claim(SlotMap* map, int handle, int value) {
+    int slot;
+    int generation;
+    
+    if (handle > 0) {
+        slot = handle_slot(handle);
+        generation = handle >> 16;
+        if (slot < 0) return 0;
+        
+        // Gap slots below it become free for later claims
+        int first_new = map->slot_count;
+        if (!grow_slots(map, slot + 1)) return 0;
+        for (int i = first_new; i < slot; i++) {
+            if (!push_free_slot(map, i)) return 0;
+        }
+        if (map->slots[slot].value != SLOT_FREE) return 0; // Duplicate handle
+        
+        // Saves from before handles had plain sequential ids
+        if (generation == 0) generation = 1;
+    } else {
+        // Reuse a free slot; entries claimed by a handle since they were pushed are stale
+        slot = -1;
+        while (map->free_count > 0) {
+            int candidate = map->free_slots[--map->free_count];
+            if (map->slots[candidate].value == SLOT_FREE) {
+                slot = candidate;
+                break;
+            }
+        }
+        if (slot < 0) {
+            slot = map->slot_count;
+            if (!grow_slots(map, slot + 1)) return 0;
+        }
+        generation = map->slots[slot].generation;
+    }
+    
+    map->slots[slot].value = value;
+    map->slots[slot].generation = generation;
+    return generation << 16 | (slot + 1);
+}
+
+/**
+ * Free a slot; its next occupant gets a new generation
+ */
+void slot_map_release(SlotMap* map, int slot) {
+    if (slot < 0 || slot >= map->slot_count) return;
+    
+    SlotEntry* entry = &map->slots[slot];
+    if (entry->value == SLOT_FREE) return;
+    entry->value = SLOT_FREE;
+    entry->generation = entry->generation >= SLOT_MAP_MAX_GENERATION ? 1 : entry->generation + 1;
+    
+    // If the stack can't grow the slot is just never reused
+    push_free_slot(map, slot);
+}
+
+/**
+ * Find the live slot for a handle, or -1 if it's gone
+ * A tile id (no generation bits) matches whoever holds the slot now.
+ */
+int slot_map_find(const SlotMap* map, int handle) {
+    if (!map || handle <= 0) return -1;
+    
+    int slot = handle_slot(handle);
+    if (slot < 0 || slot >= map->slot_count) return -1;
+    
+    const SlotEntry* entry = &map->slots[slot];
+    if (entry->value == SLOT_FREE) return -1;
+    if ((handle >> 16) != 0 && (handle >> 16) != entry->generation) return -1;
+    
+    return slot;
+}
+
+/**
+ * Copy a slot map into an empty one
+ */
+int slot_map_copy(SlotMap* dst, const SlotMap* src) {
+    memset(dst, 0, sizeof(SlotMap));
+    
+    if (!grow_slots(dst, src->slot_count)) {
+        slot_map_clear(dst);
+        return 0;
+    }
+    if (src->slot_count > 0)
+        memcpy(dst->slots, src->slots, (size_t)src->slot_count * sizeof(SlotEntry));
+    
+    for (int i = 0; i < src->free_count; i++) {
+        if (!push_free_slot(dst, src->free_slots[i])) {
+            slot_map_clear(dst);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Free the map and reset it to empty
+ */
+void slot_map_clear(SlotMap* map) {
+    free(map->slots);
+    free(map->free_slots);
+    memset(map, 0, sizeof(SlotMap));
+}
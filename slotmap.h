@@ -0,0 +1,58 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+/*
+ * Generational slot map handing out stable handles:
+ *
+ *   handle = generation << 16 | (slot + 1)
+ *
+ * The low 16 bits are what tiles store (WorldTile::entity_id and item_id),
+ * so a tile leads straight to its slot. A slot's generation changes when it
+ * is released, so an old handle kept elsewhere no longer matches whoever
+ * reuses the slot. Each slot carries one int for its owner (the enemy
+ * store keeps the enemy's dense index there).
+ */
+
+#define SLOT_MAP_MAX_SLOTS      0xFFFF  // Tile ids are 16 bits
+#define SLOT_MAP_MAX_GENERATION 0x7FFF  // Keeps handles positive
+#define SLOT_FREE               (-1)
+
+// One slot
+typedef struct SlotEntry {
+    int value;              // Owner's value (SLOT_FREE = unused)
+    int generation;         // Generation of the current (or next) occupant
+} SlotEntry;
+
+typedef struct SlotMap {
+    SlotEntry* slots;       // One per slot ever used
+    int slot_count;         // Slots in use or free
+    int slot_capacity;      // Allocated slots
+    int* free_slots;        // Stack of free slots (may hold stale live ones, skipped on pop)
+    int free_count;         // Entries on the stack
+    int free_capacity;      // Allocated stack entries
+} SlotMap;
+
+// Handles
+int slot_map_claim(SlotMap* map, int handle, int value);
+void slot_map_release(SlotMap* map, int slot);
+int slot_map_find(const SlotMap* map, int handle);
+
+// Whole map
+int slot_map_copy(SlotMap* dst, const SlotMap* src);
+void slot_map_clear(SlotMap* map);
+
+/**
+ * Slot index of a handle or tile id
+ */
+static inline int handle_slot(int handle) {
+    return (handle & 0xFFFF) - 1;
+}
+
+/**
+ * The id a tile stores for a handle (its slot + 1)
+ */
+static inline unsigned short handle_tile_id(int handle) {
+    return (unsigned short)(handle & 0xFFFF);
+}
+
+#endif /* SLOTMAP_H */
@@ -0,0 +1,200 @@
+#include "spatialhash.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Hash cell coordinates into the table
+ */
+static unsigned int cell_hash(int cx, int cy) {
+    unsigned int h = (unsigned int)cx * 0x9E3779B1u ^ (unsigned int)cy * 0x85EBCA77u;
+    return h ^ (h >> 15);
+}
+
+/**
+ * Find a cell, or NULL if nothing was ever stored there
+ */
+static SpatialCell* find_cell(const SpatialHash* hash, int cx, int cy) {
+    if (!hash->cells) return NULL;
+    
+    unsigned int mask = (unsigned int)hash->cell_capacity - 1;
+    for (unsigned int i = cell_hash(cx, cy) & mask; ; i = (i + 1) & mask) {
+        SpatialCell* cell = &hash->cells[i];
+        if (!cell->used) return NULL;
+        if (cell->cx == cx && cell->cy == cy) return cell;
+    }
+}
+
+/**
+ * Double the table and re-place every cell
+ */
+static int grow_table(SpatialHash* hash) {
+    int capacity = hash->cell_capacity ? hash->cell_capacity * 2 : 64;
+    SpatialCell* cells = (SpatialCell*)calloc((size_t)capacity, sizeof(SpatialCell));
+    if (!cells) return 0;
+    
+    unsigned int mask = (unsigned int)capacity - 1;
+    for (int i = 0; i < hash->cell_capacity; i++) {
+        SpatialCell* cell = &hash->cells[i];
+        if (!cell->used) continue;
+        
+        unsigned int j = cell_hash(cell->cx, cell->cy) & mask;
+        while (cells[j].used) j = (j + 1) & mask;
+        cells[j] = *cell;
+    }
+    
+    free(hash->cells);
+    hash->cells = cells;
+    hash->cell_capacity = capacity;
+    return 1;
+}
+
+/**
+ * Find a cell, adding it if needed
+ * Cells are never taken out again, so probe chains stay intact
+ */
+static SpatialCell* get_cell(SpatialHash* hash, int cx, int cy) {
+    SpatialCell* cell = find_cell(hash, cx, cy);
+    if (cell) return cell;
+    
+    // Keep the table at most half full
+    if ((hash->cell_count + 1) * 2 > hash->cell_capacity && !grow_table(hash)) return NULL;
+    
+    unsigned int mask = (unsigned int)hash->cell_capacity - 1;
+    unsigned int i = cell_hash(cx, cy) & mask;
+    while (hash->cells[i].used) i = (i + 1) & mask;
+    
+    cell = &hash->cells[i];
+    cell->cx = cx;
+    cell->cy = cy;
+    cell->used = 1;
+    hash->cell_count++;
+    return cell;
+}
+
+/**
+ * Add an id at a world position
+ */
+int spatial_insert(SpatialHash* hash, int id, int x, int y) {
+    SpatialCell* cell = get_cell(hash, x >> SPATIAL_CELL_SHIFT, y >> SPATIAL_CELL_SHIFT);
+    if (!cell) return 0;
+    
+    if (cell->count == cell->capacity) {
+        int capacity = cell->capacity ? cell->capacity * 2 : 4;
+        SpatialEntry* entries = (SpatialEntry*)realloc(cell->entries, (size_t)capacity * sizeof(SpatialEntry));
+        if (!entries) return 0;
+        cell->entries = entries;
+        cell->capacity = capacity;
+    }
+    
+    SpatialEntry* entry = &cell->entries[cell->count++];
+    entry->id = id;
+    entry->x = x;
+    entry->y = y;
+    return 1;
+}
+
+/**
+ * Remove an id from the cell of its (current) position
+ */
+void spatial_remove(SpatialHash* hash, int id, int x, int y) {
+    SpatialCell* cell = find_cell(hash, x >> SPATIAL_CELL_SHIFT, y >> SPATIAL_CELL_SHIFT);
+    if (!cell) return;
+    
+    for (int i = 0; i < cell->count; i++) {
+        if (cell->entries[i].id == id) {
+            cell->entries[i] = cell->entries[--cell->count];
+            return;
+        }
+    }
+}
+
+/**
+ * Move an id; only changes cells when it crosses a cell edge
+ * Returns 0, with the id still at its old position, if it can't be moved.
+ */
+int spatial_move(SpatialHash* hash, int id, int old_x, int old_y, int new_x, int new_y) {
+    int old_cx = old_x >> SPATIAL_CELL_SHIFT, old_cy = old_y >> SPATIAL_CELL_SHIFT;
+    int new_cx = new_x >> SPATIAL_CELL_SHIFT, new_cy = new_y >> SPATIAL_CELL_SHIFT;
+    
+    if (old_cx == new_cx && old_cy == new_cy) {
+        SpatialCell* cell = find_cell(hash, old_cx, old_cy);
+        for (int i = 0; cell && i < cell->count; i++) {
+            if (cell->entries[i].id == id) {
+                cell->entries[i].x = new_x;
+                cell->entries[i].y = new_y;
+                return 1;
+            }
+        }
+        return 0;
+    }
+    
+    // Insert first so a failed allocation leaves the old entry in place
+    if (!spatial_insert(hash, id, new_x, new_y)) return 0;
+    spatial_remove(hash, id, old_x, old_y);
+    return 1;
+}
+
+/**
+ * Free every cell
+ */
+void spatial_clear(SpatialHash* hash) {
+    for (int i = 0; i < hash->cell_capacity; i++) {
+        free(hash->cells[i].entries);
+    }
+    free(hash->cells);
+    memset(hash, 0, sizeof(SpatialHash));
+}
+
+/**
+ * Ids whose position lies inside a rectangle (inclusive)
+ */
+int spatial_query_rect(const SpatialHash* hash, int min_x, int min_y, int max_x, int max_y,
+                       int* out, int max_out) {
+    int found = 0;
+    if (!hash->cells || min_x > max_x || min_y > max_y) return 0;
+    
+    for (int cy = min_y >> SPATIAL_CELL_SHIFT; cy <= max_y >> SPATIAL_CELL_SHIFT; cy++) {
+        for (int cx = min_x >> SPATIAL_CELL_SHIFT; cx <= max_x >> SPATIAL_CELL_SHIFT; cx++) {
+            const SpatialCell* cell = find_cell(hash, cx, cy);
+            if (!cell) continue;
+            
+            for (int i = 0; i < cell->count; i++) {
+                const SpatialEntry* entry = &cell->entries[i];
+                if (entry->x < min_x || entry->x > max_x || entry->y < min_y || entry->y > max_y)
+                    continue;
+                if (found < max_out) out[found] = entry->id;
+                found++;
+            }
+        }
+    }
+    
+    return found;
+}
+
+/**
+ * Ids within radius (Euclidean) of a position
+ */
+int spatial_query_radius(const SpatialHash* hash, int x, int y, int radius,
+                         int* out, int max_out) {
+    int found = 0;
+    if (!hash->cells || radius < 0) return 0;
+    
+    long long radius_sq = (long long)radius * radius;
+    for (int cy = (y - radius) >> SPATIAL_CELL_SHIFT; cy <= (y + radius) >> SPATIAL_CELL_SHIFT; cy++) {
+        for (int cx = (x - radius) >> SPATIAL_CELL_SHIFT; cx <= (x + radius) >> SPATIAL_CELL_SHIFT; cx++) {
+            const SpatialCell* cell = find_cell(hash, cx, cy);
+            if (!cell) continue;
+            
+            for (int i = 0; i < cell->count; i++) {
+                const SpatialEntry* entry = &cell->entries[i];
+                long long dx = entry->x - x;
+                long long dy = entry->y - y;
+                if (dx * dx + dy * dy > radius_sq) continue;
+                if (found < max_out) out[found] = entry->id;
+                found++;
+            }
+        }
+    }
+    
+    return found;
+}
@@ -0,0 +1,48 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+/*
+ * Uniform grid over world positions for proximity queries. The world is
+ * cut into SPATIAL_CELL_SIZE square cells; only cells that ever held
+ * something are stored, in an open-addressing table keyed by cell
+ * coordinates. Each cell lists the ids and positions inside it, so a query
+ * costs the cells it covers plus their occupants, not every entity.
+ */
+
+#define SPATIAL_CELL_SHIFT  4
+#define SPATIAL_CELL_SIZE   (1 << SPATIAL_CELL_SHIFT)
+
+// Something in a cell
+typedef struct SpatialEntry {
+    int id;                 // Caller's id (the enemy store uses slots)
+    int x, y;               // World position
+} SpatialEntry;
+
+// One grid cell
+typedef struct SpatialCell {
+    int cx, cy;             // Cell coordinates
+    int used;               // Table slot holds this cell
+    SpatialEntry* entries;  // Occupants
+    int count;              // Number of occupants
+    int capacity;           // Allocated occupants
+} SpatialCell;
+
+typedef struct SpatialHash {
+    SpatialCell* cells;     // Open-addressing table (power-of-two size)
+    int cell_capacity;      // Table size
+    int cell_count;         // Cells in use
+} SpatialHash;
+
+// Updates
+int spatial_insert(SpatialHash* hash, int id, int x, int y);
+void spatial_remove(SpatialHash* hash, int id, int x, int y);
+int spatial_move(SpatialHash* hash, int id, int old_x, int old_y, int new_x, int new_y);
+void spatial_clear(SpatialHash* hash);
+
+// Queries: return the number of matches, storing the first max_out ids
+int spatial_query_rect(const SpatialHash* hash, int min_x, int min_y, int max_x, int max_y,
+                       int* out, int max_out);
+int spatial_query_radius(const SpatialHash* hash, int x, int y, int radius,
+                         int* out, int max_out);
+
+#endif /* SPATIALHASH_H */
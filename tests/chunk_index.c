@@ -0,0 +1,65 @@
+#include "../gamestate.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Chunk index: every loaded chunk is found at its own coordinates, missing
+ * chunks are not, and lookups still agree after the index is rebuilt.
+ *
+ * Build from the repository root with every module except main.c:
+ *   gcc -I. tests/chunk_index.c $(ls *.c | grep -v main.c) -lpthread -lm -o chunk_index
+ */
+
+#define SIDE 24
+
+/**
+ * Count chunks in [-SIDE/2, SIDE/2) that are found where they shouldn't be
+ * or not found where they should; every third column is left unloaded
+ * (init_world loads chunk 0,0, so the gaps avoid column 0)
+ */
+static int check_lookups(GameState* state) {
+    int bad = 0;
+
+    for (int y = -SIDE / 2; y < SIDE / 2; y++) {
+        for (int x = -SIDE / 2; x < SIDE / 2; x++) {
+            int loaded = (x + SIDE) % 3 != 2;
+            WorldChunk* chunk = get_chunk_at(state, x, y);
+            int index = get_chunk_index(state, x, y);
+
+            if (loaded) {
+                if (!chunk || chunk->x != x || chunk->y != y) bad++;
+                if (index < 0 || state->world.chunks[index] != chunk) bad++;
+            } else if (chunk || index >= 0) {
+                bad++;
+            }
+        }
+    }
+
+    return bad;
+}
+
+int main(void) {
+    GameState* state = create_game_state();
+    if (!state) return 1;
+    init_world(state, 16, 16, 1);
+
+    // Scattered load order, so the table grows while it is being filled
+    for (int i = 0; i < SIDE * SIDE; i++) {
+        int cell = (i * 97) % (SIDE * SIDE);
+        int x = cell % SIDE - SIDE / 2;
+        int y = cell / SIDE - SIDE / 2;
+        if ((x + SIDE) % 3 != 2) load_chunk(state, x, y);
+    }
+
+    int bad = check_lookups(state);
+
+    rebuild_chunk_index(&state->world);
+    bad += check_lookups(state);
+
+    printf("%s: %d bad chunk lookups over %d chunks\n", bad ? "FAIL" : "PASS", bad,
+           state->world.chunk_count);
+
+    destroy_game_state(state);
+    free(state);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#include "../enemystore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Enemy handles: a removed enemy's handle stops resolving, its slot is
+ * reused under a new generation, and the enemies that moved to fill the gap
+ * are still found through their own handles.
+ *
+ * Build from the repository root with every module except main.c:
+ *   gcc -I. tests/enemy_handles.c $(ls *.c | grep -v main.c) -lpthread -lm -o enemy_handles
+ */
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * A handle's slot part: handles are generation << 16 | (slot + 1)
+ */
+static int handle_slot_part(int handle) {
+    return handle & 0xFFFF;
+}
+
+static int add_enemy(EnemyStore* store, int x) {
+    AIEnemy enemy;
+    memset(&enemy, 0, sizeof(enemy));
+    enemy.base.x = x;
+    enemy.base.health = 10;
+    enemy.base.icon = 'E';
+
+    int index = enemy_store_add(store, &enemy);
+    return index < 0 ? 0 : store->id[index];
+}
+
+/**
+ * Whether a handle resolves to the enemy placed at x
+ */
+static int resolves_to(const EnemyStore* store, int id, int x) {
+    int index = enemy_store_find(store, id);
+    return index >= 0 && store->id[index] == id && store->x[index] == x;
+}
+
+int main(void) {
+    EnemyStore store;
+    memset(&store, 0, sizeof(store));
+
+    int a = add_enemy(&store, 1);
+    int b = add_enemy(&store, 2);
+    int c = add_enemy(&store, 3);
+    check(a && b && c && a != b && b != c && a != c, "handles are distinct");
+    check(resolves_to(&store, a, 1) && resolves_to(&store, b, 2) && resolves_to(&store, c, 3),
+          "handles resolve");
+
+    // Removing the first enemy moves the last one into its index
+    enemy_store_remove(&store, enemy_store_find(&store, a));
+    check(enemy_store_find(&store, a) < 0, "removed handle is stale");
+    check(resolves_to(&store, b, 2) && resolves_to(&store, c, 3), "survivors still resolve");
+
+    // The freed slot comes back with a different generation
+    int d = add_enemy(&store, 4);
+    check(handle_slot_part(d) == handle_slot_part(a), "freed slot is reused");
+    check(d != a, "reused slot gets a new generation");
+    check(enemy_store_find(&store, a) < 0, "old handle stays stale after reuse");
+    check(resolves_to(&store, d, 4), "new handle resolves");
+
+    // Churn through one slot; every new handle reuses it under a fresh generation
+    int last = d;
+    for (int i = 0; i < 1000; i++) {
+        enemy_store_remove(&store, enemy_store_find(&store, last));
+        int next = add_enemy(&store, 5);
+        if (next == last || enemy_store_find(&store, last) >= 0) {
+            check(0, "churned handle is stale");
+            break;
+        }
+        if (handle_slot_part(next) != handle_slot_part(d)) {
+            check(0, "churn reuses the slot");
+            break;
+        }
+        last = next;
+    }
+    check(store.count == 3 && resolves_to(&store, last, 5), "store holds the live enemies");
+
+    enemy_store_clear(&store);
+
+    printf("%s: enemy handles\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
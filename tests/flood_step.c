@@ -0,0 +1,128 @@
+#include "../tileplanes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Bit-grid flood: every step of bits_flood_step reaches exactly the tiles a
+ * breadth-first search puts at that distance, including across word edges
+ * and on grids whose width is not a multiple of 64.
+ *
+ * Build from the repository root with every module except main.c:
+ *   gcc -I. tests/flood_step.c $(ls *.c | grep -v main.c) -lpthread -lm -o flood_step
+ */
+
+#define MAX_WIDTH   200
+#define MAX_HEIGHT  48
+#define MAX_WORDS   BITS_ROW_WORDS(MAX_WIDTH)
+
+static int test_bit(const uint64_t* bits, int row_words, int x, int y) {
+    return (int)((bits[(size_t)y * row_words + (x >> 6)] >> (x & 63)) & 1);
+}
+
+static void set_bit(uint64_t* bits, int row_words, int x, int y) {
+    bits[(size_t)y * row_words + (x >> 6)] |= (uint64_t)1 << (x & 63);
+}
+
+/**
+ * Distances from (start_x, start_y) over open tiles, -1 where unreachable
+ */
+static void bfs(const uint64_t* open, int row_words, int width, int height,
+                int start_x, int start_y, int* dist) {
+    static int queue[MAX_WIDTH * MAX_HEIGHT];
+    int head = 0, tail = 0;
+
+    for (int i = 0; i < width * height; i++) dist[i] = -1;
+    dist[start_y * width + start_x] = 0;
+    queue[tail++] = start_y * width + start_x;
+
+    while (head < tail) {
+        int cell = queue[head++];
+        int x = cell % width, y = cell / width;
+        const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+        for (int d = 0; d < 4; d++) {
+            int nx = x + dirs[d][0], ny = y + dirs[d][1];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            if (!test_bit(open, row_words, nx, ny) || dist[ny * width + nx] >= 0) continue;
+            dist[ny * width + nx] = dist[cell] + 1;
+            queue[tail++] = ny * width + nx;
+        }
+    }
+}
+
+/**
+ * Flood one random grid and count tiles where a step disagrees with the BFS
+ */
+static int check_grid(int width, int height, int density, unsigned seed) {
+    static uint64_t open[MAX_WORDS * MAX_HEIGHT];
+    static uint64_t reached[MAX_WORDS * MAX_HEIGHT];
+    static uint64_t frontier[MAX_WORDS * MAX_HEIGHT];
+    static uint64_t next[MAX_WORDS * MAX_HEIGHT];
+    static int dist[MAX_WIDTH * MAX_HEIGHT];
+    int row_words = BITS_ROW_WORDS(width);
+    int bad = 0;
+
+    memset(open, 0, sizeof(open));
+    memset(reached, 0, sizeof(reached));
+    memset(frontier, 0, sizeof(frontier));
+    memset(next, 0, sizeof(next));
+
+    srand(seed);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (rand() % 100 < density) set_bit(open, row_words, x, y);
+        }
+    }
+
+    int start_x = width / 2, start_y = height / 2;
+    set_bit(open, row_words, start_x, start_y);
+    set_bit(reached, row_words, start_x, start_y);
+    set_bit(frontier, row_words, start_x, start_y);
+    bfs(open, row_words, width, height, start_x, start_y, dist);
+
+    int first_row = start_y, last_row = start_y;
+    uint64_t* from = frontier;
+    uint64_t* to = next;
+    int step = 0;
+
+    while (bits_flood_step(open, reached, from, to, row_words, height, &first_row, &last_row)) {
+        step++;
+        for (int y = 0; y < height; y++) {
+            int in_span = y >= first_row && y <= last_row;
+            for (int x = 0; x < row_words * 64; x++) {
+                int want = x < width && dist[y * width + x] == step;
+                int got = in_span && test_bit(to, row_words, x, y);
+                if (want != got) bad++;
+            }
+        }
+
+        uint64_t* swap = from;
+        from = to;
+        to = swap;
+    }
+
+    // Once the flood stops, reached is everything the BFS found
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < row_words * 64; x++) {
+            int want = x < width && dist[y * width + x] >= 0;
+            if (want != test_bit(reached, row_words, x, y)) bad++;
+        }
+    }
+
+    return bad;
+}
+
+int main(void) {
+    const int sizes[][2] = {{64, 32}, {65, 17}, {130, 48}, {200, 1}, {1, 40}, {127, 33}};
+    int bad = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (int density = 55; density <= 100; density += 15) {
+            bad += check_grid(sizes[i][0], sizes[i][1], density, (unsigned)(i * 131 + density));
+        }
+    }
+
+    printf("%s: flood step, %d mismatched tiles\n", bad ? "FAIL" : "PASS", bad);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+#include "../gamestate.h"
+#include "../fov.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Field of view: on generated terrain, whenever one floor tile sees
+ * another the reverse holds too, and a chunk streaming in next to the
+ * player is seen without the player moving.
+ *
+ * Build from the repository root with every module except main.c:
+ *   gcc -I. tests/fov_symmetry.c $(ls *.c | grep -v main.c) -lpthread -lm -o fov_symmetry
+ */
+
+#define CHUNK_SIDE 16
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static int is_floor(GameState* state, int x, int y) {
+    WorldTile* tile = get_tile_world(state, x, y);
+    return tile && tile->type == TILE_FLOOR;
+}
+
+static void look_from(GameState* state, int x, int y) {
+    state->player.x = x;
+    state->player.y = y;
+    update_fov(state);
+}
+
+/**
+ * Check every floor tile of the middle chunk against the floor tiles it sees
+ * Returns the number of one-way sightings
+ */
+static int count_asymmetric(GameState* state, int* pairs) {
+    int bad = 0;
+
+    for (int ay = CHUNK_SIDE; ay < 2 * CHUNK_SIDE; ay++) {
+        for (int ax = CHUNK_SIDE; ax < 2 * CHUNK_SIDE; ax++) {
+            if (!is_floor(state, ax, ay)) continue;
+
+            for (int by = ay - FOV_RADIUS; by <= ay + FOV_RADIUS; by++) {
+                for (int bx = ax - FOV_RADIUS; bx <= ax + FOV_RADIUS; bx++) {
+                    if (bx == ax && by == ay) continue;
+                    look_from(state, ax, ay);
+                    if (!fov_visible(state, bx, by) || !is_floor(state, bx, by)) continue;
+
+                    (*pairs)++;
+                    look_from(state, bx, by);
+                    if (!fov_visible(state, ax, ay)) bad++;
+                }
+            }
+        }
+    }
+
+    return bad;
+}
+
+static void test_symmetry(void) {
+    GameState* state = create_game_state();
+    if (!state) {
+        check(0, "create game state");
+        return;
+    }
+    init_world(state, CHUNK_SIDE, CHUNK_SIDE, 1);
+    for (int cy = 0; cy < 3; cy++) {
+        for (int cx = 0; cx < 3; cx++) {
+            load_chunk(state, cx, cy);
+        }
+    }
+
+    int pairs = 0;
+    int bad = count_asymmetric(state, &pairs);
+    check(pairs > 0, "some floor tiles see each other");
+    if (bad) printf("%d of %d sightings are one-way\n", bad, pairs);
+    check(bad == 0, "sight is symmetric");
+
+    destroy_game_state(state);
+    free(state);
+}
+
+static void test_streamed_chunk(void) {
+    GameState* state = create_game_state();
+    if (!state) {
+        check(0, "create game state");
+        return;
+    }
+    init_world(state, CHUNK_SIDE, CHUNK_SIDE, 1);
+
+    // At the edge of the only chunk, the unloaded side is not visible
+    look_from(state, CHUNK_SIDE - 1, CHUNK_SIDE / 2);
+    check(!fov_visible(state, CHUNK_SIDE, CHUNK_SIDE / 2), "unloaded tile is not visible");
+
+    // Once it streams in, the neighbouring tile is in view
+    load_chunk(state, 1, 0);
+    update_fov(state);
+    check(fov_visible(state, CHUNK_SIDE, CHUNK_SIDE / 2), "streamed-in tile is visible");
+
+    destroy_game_state(state);
+    free(state);
+}
+
+int main(void) {
+    test_symmetry();
+    test_streamed_chunk();
+
+    printf("%s: field of view\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+#include "../gamestate.h"
+#include "../level.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Level validation: malformed headers and rows are rejected without
+ * touching the world, and a well-formed level places its tiles, player
+ * start and goblins.
+ *
+ * Build from the repository root with every module except main.c:
+ *   gcc -I. tests/level_validate.c $(ls *.c | grep -v main.c) -lpthread -lm -o level_validate
+ */
+
+#define TEST_LEVEL "test_level.lvl"
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static GameState* new_state(void) {
+    GameState* state = create_game_state();
+    if (state) init_world(state, 16, 16, 1);
+    return state;
+}
+
+static void free_state(GameState* state) {
+    destroy_game_state(state);
+    free(state);
+}
+
+/**
+ * Write a level file and load it into a fresh world
+ * Returns load_level's result; the world is left in *out
+ */
+static int load_text(const char* text, GameState** out) {
+    FILE* file = fopen(TEST_LEVEL, "wb");
+    if (!file) return -1;
+    fwrite(text, 1, strlen(text), file);
+    fclose(file);
+
+    *out = new_state();
+    if (!*out) return -1;
+    return load_level(*out, TEST_LEVEL);
+}
+
+/**
+ * A malformed level must fail and leave the world as init_world made it
+ */
+static void expect_rejected(const char* text, const char* what) {
+    GameState* state = NULL;
+    int ok = load_text(text, &state);
+
+    check(ok == 0, what);
+    if (state) {
+        check(state->world.chunk_count == 1 && state->enemies.count == 0 &&
+              state->player.x == 3 && state->player.y == 3,
+              "rejected level leaves the world untouched");
+        free_state(state);
+    }
+}
+
+static void test_rejected(void) {
+    // Headers
+    expect_rejected("LVL\nw0\n", "header without sides");
+    expect_rejected("LVL 3\nw0w\n", "header without height");
+    expect_rejected("LVLx 3 1\nw0w\n", "header with a bad magic");
+    expect_rejected("LVL 0 1\n\n", "zero width");
+    expect_rejected("LVL 3 0\n", "zero height");
+    expect_rejected("LVL 99999 1\nw\n", "width over the limit");
+    expect_rejected("LVL 1 99999999999999999999\nw\n", "height that overflows");
+    expect_rejected("LVL 3 1 7\nw0w\n", "header with extra fields");
+    expect_rejected("LVL 3 1", "header without a line break");
+    expect_rejected("LVL -3 1\nw0w\n", "negative width");
+
+    // Rows
+    expect_rejected("LVL 3 2\nw0w\nw0\n", "short row");
+    expect_rejected("LVL 3 2\nw0w\nw00w\n", "long row");
+    expect_rejected("LVL 3 2\nw0w\n", "missing row");
+    expect_rejected("LVL 3 2\nw0w\nwxw\n", "unknown cell");
+    expect_rejected("LVL 3 2\nw@w\nw@w\n", "two player starts");
+    expect_rejected("LVL 3 1\nw0w\nw0w\n", "data after the last row");
+
+    // Legacy levels must fill whole rows
+    expect_rejected("wwwwwwwwwwwwwwwwwww\n", "partial legacy row");
+    expect_rejected("", "empty file");
+}
+
+static void test_accepted(void) {
+    GameState* state = NULL;
+    int ok = load_text("LVL 3 2\r\nw@0\r\n0Gw\r\n\n", &state);
+
+    check(ok == 1, "well-formed level loads");
+    if (state && ok == 1) {
+        WorldTile* wall = get_tile_world(state, 0, 0);
+        WorldTile* floor = get_tile_world(state, 2, 0);
+        WorldTile* outside = get_tile_world(state, 3, 0);
+        check(wall && wall->type == TILE_WALL, "wall cell");
+        check(floor && floor->type == TILE_FLOOR, "floor cell");
+        check(outside && outside->type == TILE_EMPTY, "cells past the level are empty");
+        check(state->player.x == 1 && state->player.y == 0, "player start");
+        check(state->enemies.count == 1 && state->enemies.x[0] == 1 && state->enemies.y[0] == 1,
+              "goblin spawned");
+    }
+    if (state) free_state(state);
+
+    // Headerless levels are LEVEL_LEGACY_WIDTH wide, line breaks optional
+    char legacy[2 * LEVEL_LEGACY_WIDTH + 2];
+    memset(legacy, '0', sizeof(legacy));
+    legacy[LEVEL_LEGACY_WIDTH] = '\n';
+    legacy[2 * LEVEL_LEGACY_WIDTH] = 'w';
+    legacy[2 * LEVEL_LEGACY_WIDTH + 1] = '\0';
+    ok = load_text(legacy, &state);
+    check(ok == 1, "legacy level loads");
+    if (state && ok == 1) {
+        WorldTile* last = get_tile_world(state, LEVEL_LEGACY_WIDTH - 1, 1);
+        check(last && last->type == TILE_WALL, "legacy rows");
+    }
+    if (state) free_state(state);
+}
+
+int main(void) {
+    test_rejected();
+    test_accepted();
+    remove(TEST_LEVEL);
+
+    printf("%s: level validation\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
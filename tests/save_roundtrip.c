@@ -0,0 +1,79 @@
+#include "../gamestate.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Regression test: loading a save must not make enemies replay missed turns.
+ * Enemies that were active before the save should move at most one tile on
+ * the first turn after the load.
+ *
+ * Build from the repository root:
+ *   gcc -I. tests/save_roundtrip.c $(ls *.c | grep -v main.c) -lpthread -lm -o save_roundtrip
+ */
+
+#define TEST_SAVE "test_roundtrip.sav"
+
+int main(void) {
+    GameState* state = create_game_state();
+    if (!state) return 1;
+
+    init_world(state, 20, 14, 5);
+    for (int y = -2; y <= 2; y++) {
+        for (int x = -2; x <= 2; x++) load_chunk(state, x, y);
+    }
+    state->player.x = 2;
+    state->player.y = 2;
+
+    for (int i = 0; i < 200; i++) {
+        AIEnemy enemy = {0};
+        enemy.base.icon = 'G';
+        enemy.base.health = 5;
+        enemy.detection_radius = 12;
+        enemy.base.x = (i * 13) % 40 - 20;
+        enemy.base.y = (i * 7) % 28 - 14;
+
+        const WorldTile* tile = get_tile_world(state, enemy.base.x, enemy.base.y);
+        if (tile && tile_walkable(tile) && tile->entity_id == 0) add_enemy(state, enemy);
+    }
+
+    for (int turn = 0; turn < 100; turn++) update_game_state(state);
+
+    if (!save_game(state, TEST_SAVE)) {
+        printf("FAIL: save\n");
+        return 1;
+    }
+
+    GameState* loaded = create_game_state();
+    if (!loaded || !load_game(loaded, TEST_SAVE)) {
+        printf("FAIL: load\n");
+        return 1;
+    }
+    remove(TEST_SAVE);
+
+    int count = loaded->enemies.count;
+    int* before = (int*)malloc((2 * count + 1) * sizeof(int));
+    if (!before) return 1;
+    for (int i = 0; i < count; i++) {
+        before[2 * i] = loaded->enemies.x[i];
+        before[2 * i + 1] = loaded->enemies.y[i];
+    }
+
+    update_game_state(loaded);
+
+    int jumped = 0;
+    for (int i = 0; i < count; i++) {
+        int dx = abs(loaded->enemies.x[i] - before[2 * i]);
+        int dy = abs(loaded->enemies.y[i] - before[2 * i + 1]);
+        if (dx > 1 || dy > 1) jumped++;
+    }
+
+    printf("%s: %d of %d enemies moved more than one tile after loading\n",
+           jumped ? "FAIL" : "PASS", jumped, count);
+
+    free(before);
+    destroy_game_state(state);
+    free(state);
+    destroy_game_state(loaded);
+    free(loaded);
+    return jumped ? 1 : 0;
+}
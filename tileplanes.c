@@ -0,0 +1,156 @@
+#include "tileplanes.h"
+#include "gamestate.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Recompute every bit of a chunk's planes from its tiles
+ */
+static void build_planes(TilePlanes* planes, const WorldChunk* chunk) {
+    size_t words = (size_t)planes->height * planes->row_words;
+    for (int p = 0; p < PLANE_COUNT; p++) {
+        memset(planes->bits[p], 0, words * sizeof(uint64_t));
+    }
+
+    for (int y = 0; y < planes->height; y++) {
+        const WorldTile* row = CHUNK_TILE(chunk, 0, y);
+        uint64_t* walkable = planes->bits[PLANE_WALKABLE] + (size_t)y * planes->row_words;
+        uint64_t* transparent = planes->bits[PLANE_TRANSPARENT] + (size_t)y * planes->row_words;
+        uint64_t* occupied = planes->bits[PLANE_OCCUPIED] + (size_t)y * planes->row_words;
+
+        for (int x = 0; x < planes->width; x++) {
+            uint64_t bit = (uint64_t)1 << (x & 63);
+            if (tile_walkable(&row[x])) walkable[x >> 6] |= bit;
+            if (tile_transparent(&row[x])) transparent[x >> 6] |= bit;
+            if (row[x].entity_id != 0) occupied[x >> 6] |= bit;
+        }
+    }
+
+    planes->valid = 1;
+}
+
+/**
+ * Get a chunk's planes, building them if they are missing or stale
+ * Returns NULL if the chunk's tiles aren't loaded or memory runs out
+ */
+TilePlanes* build_chunk_planes(WorldChunk* chunk) {
+    TilePlanes* planes = chunk->planes;
+    if (planes && planes->valid) return planes;
+    if (!chunk->tiles) return NULL;
+
+    if (!planes) {
+        int row_words = BITS_ROW_WORDS(chunk->width);
+        size_t words = (size_t)chunk->height * row_words;
+        planes = (TilePlanes*)malloc(sizeof(TilePlanes) + PLANE_COUNT * words * sizeof(uint64_t));
+        if (!planes) return NULL;
+
+        planes->width = chunk->width;
+        planes->height = chunk->height;
+        planes->row_words = row_words;
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            planes->bits[p] = (uint64_t*)(planes + 1) + p * words;
+        }
+        chunk->planes = planes;
+    }
+
+    build_planes(planes, chunk);
+    return planes;
+}
+
+/**
+ * Mark a chunk's planes stale after its tiles were replaced
+ */
+void invalidate_chunk_planes(WorldChunk* chunk) {
+    if (chunk->planes) chunk->planes->valid = 0;
+}
+
+/**
+ * Bring one tile's bits in line with the tile (stale planes are left alone)
+ */
+void update_tile_planes(WorldChunk* chunk, int x, int y) {
+    TilePlanes* planes = chunk->planes;
+    if (!planes || !planes->valid) return;
+
+    const WorldTile* tile = CHUNK_TILE(chunk, x, y);
+    plane_set(planes, PLANE_WALKABLE, x, y, tile_walkable(tile));
+    plane_set(planes, PLANE_TRANSPARENT, x, y, tile_transparent(tile));
+    plane_set(planes, PLANE_OCCUPIED, x, y, tile->entity_id != 0);
+}
+
+/**
+ * Free a chunk's planes
+ */
+void free_tile_planes(TilePlanes* planes) {
+    free(planes);
+}
+
+/**
+ * Copy count bits from the start of src into dst starting at bit dst_bit
+ * Bits of dst outside the copied range are kept.
+ */
+void bits_copy(uint64_t* dst, int dst_bit, const uint64_t* src, int count) {
+    for (int done = 0; done < count; ) {
+        int word = (dst_bit + done) >> 6;
+        int shift = (dst_bit + done) & 63;
+        int take = 64 - shift;
+        if (take > count - done) take = count - done;
+
+        // The next take bits of src, starting at bit done
+        uint64_t chunk = src[done >> 6] >> (done & 63);
+        if ((done & 63) + take > 64) chunk |= src[(done >> 6) + 1] << (64 - (done & 63));
+        uint64_t mask = take == 64 ? ~(uint64_t)0 : (((uint64_t)1 << take) - 1);
+
+        dst[word] = (dst[word] & ~(mask << shift)) | ((chunk & mask) << shift);
+        done += take;
+    }
+}
+
+/**
+ * Advance a 4-connected flood on a bit grid by one step
+ * frontier holds the tiles reached by the last step in rows *first_row to
+ * *last_row (other rows are ignored). next receives the open, unreached
+ * neighbours of those tiles and they are added to reached; the row span is
+ * updated to the rows of next that got any. Returns 0 once nothing was added.
+ */
+int bits_flood_step(const uint64_t* open, uint64_t* reached, const uint64_t* frontier,
+                    uint64_t* next, int row_words, int height, int* first_row, int* last_row) {
+    int from = *first_row > 0 ? *first_row - 1 : 0;
+    int to = *last_row + 1 < height ? *last_row + 1 : height - 1;
+    int new_first = height;
+    int new_last = -1;
+
+    for (int y = from; y <= to; y++) {
+        const uint64_t* row = frontier + (size_t)y * row_words;
+        const uint64_t* above = y - 1 >= *first_row && y - 1 <= *last_row ? row - row_words : NULL;
+        const uint64_t* below = y + 1 >= *first_row && y + 1 <= *last_row ? row + row_words : NULL;
+        int in_span = y >= *first_row && y <= *last_row;
+        size_t base = (size_t)y * row_words;
+        uint64_t any = 0;
+
+        for (int i = 0; i < row_words; i++) {
+            // Left and right neighbours, carrying across word edges
+            uint64_t grown = 0;
+            if (in_span) {
+                grown = row[i] | (row[i] << 1) | (row[i] >> 1);
+                if (i > 0) grown |= row[i - 1] >> 63;
+                if (i + 1 < row_words) grown |= row[i + 1] << 63;
+            }
+            if (above) grown |= above[i];
+            if (below) grown |= below[i];
+
+            uint64_t fresh = grown & open[base + i] & ~reached[base + i];
+            next[base + i] = fresh;
+            reached[base + i] |= fresh;
+            any |= fresh;
+        }
+
+        if (any) {
+            if (y < new_first) new_first = y;
+            new_last = y;
+        }
+    }
+
+    *first_row = new_first;
+    *last_row = new_last;
+    return new_last >= 0;
+}
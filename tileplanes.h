@@ -0,0 +1,114 @@
+#ifndef TILEPLANES_H
+#define TILEPLANES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Packed 1-bit planes over a chunk's tiles, so searches can test 64 tiles of
+ * a row with one word instead of loading a WorldTile per cell. Rows start on
+ * a word boundary; bits past the chunk width are always zero.
+ *
+ * The planes are derived from the tiles: chunk_planes (gamestate.h) builds
+ * them on first use and again after the tile storage is replaced wholesale
+ * (allocation, level or save loading). Single-tile edits (set_tile_world, entities moving) keep
+ * them current through update_tile_planes.
+ *
+ * The bits_* helpers work on any grid of rows stored this way.
+ */
+
+struct WorldChunk;
+
+// Plane indices
+#define PLANE_WALKABLE      0   // TILE_FLAG_WALKABLE
+#define PLANE_TRANSPARENT   1   // TILE_FLAG_TRANSPARENT
+#define PLANE_OCCUPIED      2   // An entity stands on the tile
+#define PLANE_COUNT         3
+
+// Words needed for a row of bits
+#define BITS_ROW_WORDS(width) (((width) + 63) / 64)
+
+typedef struct TilePlanes {
+    int width, height;      // Chunk size in tiles
+    int row_words;          // 64-bit words per row
+    int valid;              // Whether the bits match the tiles
+    uint64_t* bits[PLANE_COUNT];    // height * row_words words per plane
+} TilePlanes;
+
+// Maintenance
+TilePlanes* build_chunk_planes(struct WorldChunk* chunk);
+void invalidate_chunk_planes(struct WorldChunk* chunk);
+void update_tile_planes(struct WorldChunk* chunk, int x, int y);
+void free_tile_planes(TilePlanes* planes);
+
+// Bit grids
+void bits_copy(uint64_t* dst, int dst_bit, const uint64_t* src, int count);
+int bits_flood_step(const uint64_t* open, uint64_t* reached, const uint64_t* frontier,
+                    uint64_t* next, int row_words, int height, int* first_row, int* last_row);
+
+/**
+ * A plane's row as words
+ */
+static inline const uint64_t* plane_row(const TilePlanes* planes, int plane, int y) {
+    return planes->bits[plane] + (size_t)y * planes->row_words;
+}
+
+/**
+ * Test one tile's bit (no bounds check)
+ */
+static inline int plane_test(const TilePlanes* planes, int plane, int x, int y) {
+    return (int)((plane_row(planes, plane, y)[x >> 6] >> (x & 63)) & 1);
+}
+
+/**
+ * Set or clear one tile's bit (no bounds check)
+ */
+static inline void plane_set(TilePlanes* planes, int plane, int x, int y, int value) {
+    uint64_t* word = planes->bits[plane] + (size_t)y * planes->row_words + (x >> 6);
+    uint64_t mask = (uint64_t)1 << (x & 63);
+    if (value) {
+        *word |= mask;
+    } else {
+        *word &= ~mask;
+    }
+}
+
+/**
+ * Whether a tile can be entered: walkable and not occupied (no bounds check)
+ */
+static inline int plane_open(const TilePlanes* planes, int x, int y) {
+    uint64_t word = plane_row(planes, PLANE_WALKABLE, y)[x >> 6] &
+                    ~plane_row(planes, PLANE_OCCUPIED, y)[x >> 6];
+    return (int)((word >> (x & 63)) & 1);
+}
+
+/**
+ * Index of the lowest set bit (word must not be zero)
+ */
+static inline int bits_lowest(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * Number of set bits in a word
+ */
+static inline int bits_count(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word; word &= word - 1) count++;
+    return count;
+#endif
+}
+
+#endif /* TILEPLANES_H */
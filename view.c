@@ -0,0 +1,100 @@
+#include "view.h"
+#include "fov.h"
+
+/**
+ * Floor division, so pages left of or above the origin line up too
+ */
+static int floor_div(int value, int divisor) {
+    int quotient = value / divisor;
+    if (value % divisor < 0) quotient--;
+    return quotient;
+}
+
+/**
+ * Place the view on the page containing the player
+ */
+void view_follow_player(const GameState* state, View* view, int width, int height) {
+    if (!state || !view) return;
+
+    view->width = width;
+    view->height = height;
+    view->origin_x = floor_div(state->player.x, width) * width;
+    view->origin_y = floor_div(state->player.y, height) * height;
+}
+
+/**
+ * Describe what is shown at a world position
+ */
+ViewCell view_cell(GameState* state, int x, int y) {
+    ViewCell cell = { VIEW_NOTHING, VIEW_UNSEEN, TILE_EMPTY, ' ' };
+
+    if (fov_visible(state, x, y)) {
+        cell.visibility = VIEW_VISIBLE;
+    } else if (fov_explored(state, x, y)) {
+        cell.visibility = VIEW_REMEMBERED;
+    } else {
+        return cell;
+    }
+
+    WorldTile* tile = get_tile_world(state, x, y);
+    if (!tile) return cell;
+
+    cell.kind = VIEW_TERRAIN;
+    cell.tile = tile->type;
+    cell.glyph = tile->display_char;
+
+    if (state->player.x == x && state->player.y == y) {
+        cell.kind = VIEW_PLAYER;
+        cell.glyph = '@';
+        return cell;
+    }
+
+    // Enemies out of sight may have moved on, so they are not remembered
+    if (tile->entity_id > 0 && cell.visibility == VIEW_VISIBLE) {
+        int index = get_enemy(state, tile->entity_id);
+        if (index >= 0) {
+            cell.kind = VIEW_ENEMY;
+            cell.glyph = state->enemies.icon[index];
+            return cell;
+        }
+    }
+
+    if (tile->item_id > 0) {
+        GameItem* item = get_item(state, tile->item_id);
+        if (item) {
+            cell.kind = VIEW_ITEM;
+            cell.glyph = item->icon;
+        }
+    }
+
+    return cell;
+}
+
+/**
+ * Store indices of the enemies inside the view that the player can see
+ * Returns the number found; only the first max_out are stored
+ */
+int view_enemies(GameState* state, const View* view, int* out, int max_out) {
+    if (!state || !view) return 0;
+
+    // Everything in sight lies within FOV_RADIUS of the player, one enemy per tile
+    int nearby[(2 * FOV_RADIUS + 1) * (2 * FOV_RADIUS + 1)];
+    int found = get_enemies_in_radius(state, state->player.x, state->player.y, FOV_RADIUS,
+                                      nearby, (int)(sizeof(nearby) / sizeof(nearby[0])));
+    if (found > (int)(sizeof(nearby) / sizeof(nearby[0]))) found = (int)(sizeof(nearby) / sizeof(nearby[0]));
+
+    int seen = 0;
+    for (int i = 0; i < found; i++) {
+        int x = state->enemies.x[nearby[i]];
+        int y = state->enemies.y[nearby[i]];
+        if (x < view->origin_x || x >= view->origin_x + view->width ||
+            y < view->origin_y || y >= view->origin_y + view->height ||
+            !fov_visible(state, x, y)) {
+            continue;
+        }
+        if (seen < max_out) out[seen] = nearby[i];
+        seen++;
+    }
+
+    return seen;
+}
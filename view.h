@@ -0,0 +1,50 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+#include "gamestate.h"
+
+/*
+ * Read-only window onto the game state for the renderer and input code.
+ * Everything is read straight from the chunks, the enemy store and the
+ * item store, so nothing has to be copied or kept in sync between turns.
+ * The window is a screen-sized page of the world; it flips to the next
+ * page when the player walks off its edge. Cells follow the player's field
+ * of view (see fov.h): enemies only show while in sight, and tiles seen
+ * before are remembered as they were.
+ */
+
+// What occupies a map position, topmost first
+typedef enum {
+    VIEW_NOTHING = 0,   // Never seen, or no chunk loaded here
+    VIEW_TERRAIN,       // Bare tile
+    VIEW_ITEM,          // Top item of the tile's stack
+    VIEW_ENEMY,         // An enemy
+    VIEW_PLAYER         // The player
+} ViewKind;
+
+// How much the player knows about a map position
+typedef enum {
+    VIEW_UNSEEN = 0,    // Never seen; nothing is shown
+    VIEW_REMEMBERED,    // Seen before, out of sight now; terrain and items only
+    VIEW_VISIBLE        // In sight this turn
+} ViewVisibility;
+
+// One map position as the renderer sees it
+typedef struct ViewCell {
+    unsigned char kind;     // ViewKind
+    unsigned char visibility;   // ViewVisibility
+    unsigned char tile;     // TileType underneath
+    char glyph;             // Enemy or item icon, tile display character otherwise
+} ViewCell;
+
+// A screen-sized page of the world
+typedef struct View {
+    int origin_x, origin_y; // World position of the top-left cell
+    int width, height;      // Size in tiles
+} View;
+
+void view_follow_player(const GameState* state, View* view, int width, int height);
+ViewCell view_cell(GameState* state, int x, int y);
+int view_enemies(GameState* state, const View* view, int* out, int max_out);
+
+#endif /* VIEW_H */
@@ -0,0 +1,256 @@
+#include "workpool.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+// One thread's queue of item numbers; the owner pops from the back,
+// thieves take from the front
+typedef struct WorkDeque {
+    pthread_mutex_t lock;
+    int* items;             // Item numbers
+    int capacity;           // Allocated items
+    int head, tail;         // Items left are items[head..tail)
+} WorkDeque;
+
+// Arguments for a worker thread
+typedef struct WorkerArgs {
+    WorkPool* pool;
+    int index;              // Deque this worker owns (1 and up; 0 is the caller's)
+} WorkerArgs;
+
+struct WorkPool {
+    int threads;            // Threads taking part, the caller included
+    WorkDeque* deques;      // One per thread
+    pthread_t* workers;     // threads - 1 worker threads
+    WorkerArgs* args;       // Their arguments
+    int started;            // Worker threads actually running
+
+    pthread_mutex_t lock;   // Guards everything below
+    pthread_cond_t ready;   // Signalled when a batch starts or the pool stops
+    pthread_cond_t done;    // Signalled when a worker finishes its share
+    unsigned int batch;     // Bumped for every batch
+    WorkFn fn;              // Current batch
+    void* context;
+    int pending;            // Items of the batch not finished yet
+    int busy;               // Workers still inside the batch
+    int stop;               // Workers should exit
+};
+
+/**
+ * Take an item from the back of a thread's own deque
+ */
+static int pop_item(WorkDeque* deque, int* item) {
+    pthread_mutex_lock(&deque->lock);
+    int found = deque->tail > deque->head;
+    if (found) *item = deque->items[--deque->tail];
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/**
+ * Take an item from the front of another thread's deque
+ */
+static int steal_item(WorkDeque* deque, int* item) {
+    pthread_mutex_lock(&deque->lock);
+    int found = deque->tail > deque->head;
+    if (found) *item = deque->items[deque->head++];
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/**
+ * Run items until every deque is empty
+ * Returns the number of items this thread ran
+ */
+static int drain(WorkPool* pool, int self, WorkFn fn, void* context) {
+    int ran = 0;
+    int item;
+
+    for (;;) {
+        int found = pop_item(&pool->deques[self], &item);
+
+        // Victims are tried in order starting after this thread
+        for (int i = 1; !found && i < pool->threads; i++) {
+            found = steal_item(&pool->deques[(self + i) % pool->threads], &item);
+        }
+        if (!found) return ran;
+
+        fn(context, item, self);
+        ran++;
+    }
+}
+
+/**
+ * Worker thread: wait for a batch, help run it, repeat until stopped
+ */
+static void* worker_main(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    WorkPool* pool = args->pool;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->batch == seen) {
+            pthread_cond_wait(&pool->ready, &pool->lock);
+        }
+        if (pool->stop) break;
+
+        seen = pool->batch;
+        WorkFn fn = pool->fn;
+        void* context = pool->context;
+        pool->busy++;
+        pthread_mutex_unlock(&pool->lock);
+
+        int ran = drain(pool, args->index, fn, context);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->pending -= ran;
+        pool->busy--;
+        pthread_cond_broadcast(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * Create a pool of threads (the calling thread counts as one)
+ * Returns NULL if threads < 1 or setup fails
+ */
+WorkPool* work_pool_create(int threads) {
+    if (threads < 1) return NULL;
+
+    WorkPool* pool = (WorkPool*)calloc(1, sizeof(WorkPool));
+    if (!pool) return NULL;
+
+    pool->threads = threads;
+    pool->deques = (WorkDeque*)calloc(threads, sizeof(WorkDeque));
+    pool->workers = (pthread_t*)calloc(threads, sizeof(pthread_t));
+    pool->args = (WorkerArgs*)calloc(threads, sizeof(WorkerArgs));
+    if (!pool->deques || !pool->workers || !pool->args) {
+        free(pool->deques);
+        free(pool->workers);
+        free(pool->args);
+        free(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->ready, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (int i = 1; i < threads; i++) {
+        pool->args[i].pool = pool;
+        pool->args[i].index = i;
+        if (pthread_create(&pool->workers[i], NULL, worker_main, &pool->args[i]) != 0) {
+            work_pool_destroy(pool);
+            return NULL;
+        }
+        pool->started++;
+    }
+
+    return pool;
+}
+
+/**
+ * Run fn(context, item, thread) for every item in [0, count) and wait for all of them
+ * Items are dealt out in contiguous runs, one run per thread.
+ */
+void work_pool_run(WorkPool* pool, int count, WorkFn fn, void* context) {
+    if (count <= 0 || !fn) return;
+
+    // Without helpers (or with one item) there is nothing to hand out
+    if (!pool || pool->threads == 1 || count == 1) {
+        for (int i = 0; i < count; i++) fn(context, i, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    // Workers still leaving the last batch would pick up the wrong fn
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+
+    for (int t = 0; t < pool->threads; t++) {
+        WorkDeque* deque = &pool->deques[t];
+        int first = (int)((long long)count * t / pool->threads);
+        int last = (int)((long long)count * (t + 1) / pool->threads);
+
+        pthread_mutex_lock(&deque->lock);
+        if (deque->capacity < last - first) {
+            int* items = (int*)realloc(deque->items, (last - first) * sizeof(int));
+            if (!items) {
+                // Out of memory: empty what was dealt and run the batch here
+                pthread_mutex_unlock(&deque->lock);
+                for (int i = 0; i < t; i++) pool->deques[i].head = pool->deques[i].tail = 0;
+                pthread_mutex_unlock(&pool->lock);
+                for (int i = 0; i < count; i++) fn(context, i, 0);
+                return;
+            }
+            deque->items = items;
+            deque->capacity = last - first;
+        }
+
+        // Reversed, so the owner pops its run front to back
+        deque->head = 0;
+        deque->tail = last - first;
+        for (int i = 0; i < deque->tail; i++) {
+            deque->items[i] = last - 1 - i;
+        }
+        pthread_mutex_unlock(&deque->lock);
+    }
+
+    pool->fn = fn;
+    pool->context = context;
+    pool->pending = count;
+    pool->batch++;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    int ran = drain(pool, 0, fn, context);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending -= ran;
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Number of threads taking part in a batch, the caller included
+ */
+int work_pool_threads(const WorkPool* pool) {
+    return pool ? pool->threads : 1;
+}
+
+/**
+ * Stop the workers and free the pool
+ */
+void work_pool_destroy(WorkPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i <= pool->started; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    for (int i = 0; i < pool->threads; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].items);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->ready);
+    pthread_cond_destroy(&pool->done);
+
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->args);
+    free(pool);
+}
@@ -0,0 +1,25 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+/*
+ * Fixed set of worker threads for running a batch of independent items in
+ * parallel. Each thread has its own deque of item numbers: it works from
+ * the back of its own deque and, once that is empty, steals from the front
+ * of the others, so a thread that drew cheap items helps with the rest.
+ * The calling thread takes part as thread 0; work_pool_run returns once
+ * every item has finished.
+ */
+
+// Runs one item on a thread (0 to threads - 1, 0 being the caller);
+// must be safe to call from several threads at once
+typedef void (*WorkFn)(void* context, int item, int thread);
+
+typedef struct WorkPool WorkPool;
+
+// Work pool API
+WorkPool* work_pool_create(int threads);
+void work_pool_run(WorkPool* pool, int count, WorkFn fn, void* context);
+int work_pool_threads(const WorkPool* pool);
+void work_pool_destroy(WorkPool* pool);
+
+#endif /* WORKPOOL_H */